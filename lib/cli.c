@@ -0,0 +1,180 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        Command line interpreter - fixed buffers
+ * -------------------------------------------------------------+ 
+ *
+ * @file        cli.c
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+// include libraries
+#include <string.h>
+#include "cli.h"
+
+/** @var Command table */
+static const TCliCommand *cliTable;
+/** @var Line buffer */
+static char cliLine[CLI_LINE_SIZE];
+/** @var Line length */
+static uint8_t cliLength = 0;
+/** @var Line too long - dropped till end of line */
+static uint8_t cliOverflow = 0;
+
+/**
+ * @desc    Init interpreter
+ *
+ * @param   const TCliCommand * table in flash terminated by name NULL
+ *
+ * @return  void
+ */
+void CLI_Init(const TCliCommand *table)
+{
+  // commands
+  cliTable = table;
+  // empty line
+  cliLength = 0;
+  cliOverflow = 0;
+}
+
+/**
+ * @desc    Feed received character
+ *
+ * @param   char
+ *
+ * @return  char
+ */
+char CLI_Feed(char c)
+{
+  // end of line
+  if ((c == '\r') || (c == '\n')) {
+    // check if empty line or dropped line
+    if ((cliLength == 0) || cliOverflow) {
+      cliLength = 0;
+      cliOverflow = 0;
+      return CLI_SUCCESS;
+    }
+    // terminate line
+    cliLine[cliLength] = '\0';
+    return CLI_LINE;
+  }
+  // check if room in line
+  if (cliLength >= (CLI_LINE_SIZE - 1)) {
+    // drop line
+    cliOverflow = 1;
+    return CLI_ERROR;
+  }
+  // store character
+  cliLine[cliLength++] = c;
+  return CLI_SUCCESS;
+}
+
+/**
+ * @desc    Parse number - decimal or hex with 0x
+ *
+ * @param   const char *
+ * @param   uint16_t *
+ *
+ * @return  char
+ */
+char CLI_Number(const char *str, uint16_t *number)
+{
+  uint16_t value = 0;
+  uint8_t base = 10;
+  uint8_t digit;
+
+  // hex prefix
+  if ((str[0] == '0') && ((str[1] == 'x') || (str[1] == 'X'))) {
+    base = 16;
+    str += 2;
+  }
+  // empty number
+  if (*str == '\0') {
+    return CLI_ERROR;
+  }
+  // loop through digits
+  while (*str) {
+    if ((*str >= '0') && (*str <= '9')) {
+      digit = *str - '0';
+    } else if ((*str >= 'a') && (*str <= 'f')) {
+      digit = *str - 'a' + 10;
+    } else if ((*str >= 'A') && (*str <= 'F')) {
+      digit = *str - 'A' + 10;
+    } else {
+      return CLI_ERROR;
+    }
+    // check digit and overflow
+    if ((digit >= base) || (value > (0xFFFF - digit) / base)) {
+      return CLI_ERROR;
+    }
+    value = value * base + digit;
+    str++;
+  }
+  // success
+  *number = value;
+  return CLI_SUCCESS;
+}
+
+/**
+ * @desc    Execute complete line
+ *
+ * @param   char * reply buffer CLI_REPLY_SIZE
+ *
+ * @return  uint8_t length of reply
+ */
+uint8_t CLI_Execute(char *reply)
+{
+  char *argv[CLI_MAX_ARGS];
+  uint8_t argc = 0;
+  uint8_t length;
+  char *p = cliLine;
+  const TCliCommand *command;
+  const char *name;
+  char (*handler)(uint8_t, char **, char *);
+  char status = CLI_ERROR;
+
+  // split to words in place
+  while (*p && (argc < CLI_MAX_ARGS)) {
+    // skip spaces
+    while (*p == ' ') {
+      *p++ = '\0';
+    }
+    // word start
+    if (*p) {
+      argv[argc++] = p;
+    }
+    // word end
+    while (*p && (*p != ' ')) {
+      p++;
+    }
+  }
+  // line consumed
+  cliLength = 0;
+  // default reply
+  strcpy_P(reply, PSTR("err"));
+  // look up command - table and names in flash
+  if (argc) {
+    for (command = cliTable; (name = pgm_read_ptr(&command->name)) != NULL; command++) {
+      if (strcmp_P(argv[0], name) == 0) {
+        // check arguments
+        if ((argc - 1) >= pgm_read_byte(&command->args)) {
+          reply[0] = '\0';
+          handler = pgm_read_ptr(&command->handler);
+          status = handler(argc - 1, argv + 1, reply);
+        }
+        break;
+      }
+    }
+  }
+  // handler gives no text
+  if ((status == CLI_SUCCESS) && (reply[0] == '\0')) {
+    strcpy_P(reply, PSTR("ok"));
+  } else if ((status != CLI_SUCCESS) && (reply[0] == '\0')) {
+    strcpy_P(reply, PSTR("err"));
+  }
+  // end of line
+  length = strlen(reply);
+  reply[length++] = '\r';
+  reply[length++] = '\n';
+  return length;
+}
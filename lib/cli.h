@@ -0,0 +1,84 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        Command line interpreter - fixed buffers
+ * -------------------------------------------------------------+ 
+ *
+ * @file        cli.h
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+#include <stdint.h>
+#if defined(__AVR__)
+  #include <avr/pgmspace.h>
+#else
+  #include "hostpgm.h"
+#endif
+
+#ifndef __CLI_H__
+#define __CLI_H__
+
+  // max length of command line
+  #ifndef CLI_LINE_SIZE
+    #define CLI_LINE_SIZE  32
+  #endif
+  // max number of words incl. command
+  #define CLI_MAX_ARGS     5
+  // max length of reply incl. end of line
+  #define CLI_REPLY_SIZE   40
+
+  // return values
+  #define CLI_SUCCESS      0
+  #define CLI_ERROR        1
+  // line complete
+  #define CLI_LINE         2
+
+  /** @struct Command - name, min number of arguments, handler;
+   *          table and names are kept in flash (PROGMEM) */
+  typedef struct {
+    // command name in flash
+    const char *name;
+    // minimal number of arguments
+    uint8_t args;
+    // handler - writes reply text, returns CLI_SUCCESS / CLI_ERROR
+    char (*handler)(uint8_t, char **, char *);
+  } TCliCommand;
+
+  /**
+   * @desc    Init interpreter
+   *
+   * @param   const TCliCommand * table in flash terminated by name NULL
+   *
+   * @return  void
+   */
+  void CLI_Init(const TCliCommand *);
+
+  /**
+   * @desc    Feed received character
+   *
+   * @param   char
+   *
+   * @return  char
+   */
+  char CLI_Feed(char);
+
+  /**
+   * @desc    Execute complete line
+   *
+   * @param   char * reply buffer CLI_REPLY_SIZE
+   *
+   * @return  uint8_t length of reply
+   */
+  uint8_t CLI_Execute(char *);
+
+  /**
+   * @desc    Parse number - decimal or hex with 0x
+   *
+   * @param   const char *
+   * @param   uint16_t *
+   *
+   * @return  char
+   */
+  char CLI_Number(const char *, uint16_t *);
+
+#endif
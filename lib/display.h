@@ -0,0 +1,87 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Display backend selected at compile time
+ * -------------------------------------------------------------+
+ *
+ * @file        display.h
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+
+ */
+
+#ifndef __DISPLAY_H__
+#define __DISPLAY_H__
+
+  // backends - DISPLAY_BACKEND
+  #define DISPLAY_ST7735  0   // st7735.c over SPI
+  #define DISPLAY_SSD1306 1   // ssd1306.c over TWI
+  #define DISPLAY_HOST    2   // st7735.c into simulated controller, hostlcd.c
+  #define DISPLAY_NULL    3   // nothing drawn, bus benchmarks
+
+  #ifndef DISPLAY_BACKEND
+    #define DISPLAY_BACKEND DISPLAY_ST7735
+  #endif
+
+  // init finished - DisplayInitStep
+  #define DISPLAY_INIT_DONE 0xFFFF
+
+  #if (DISPLAY_BACKEND == DISPLAY_ST7735) || (DISPLAY_BACKEND == DISPLAY_HOST)
+
+    #include "st7735.h"
+
+    // init in steps, ms to wait returned
+    #define DisplayInitStep() St7735InitStep()
+
+  #elif DISPLAY_BACKEND == DISPLAY_SSD1306
+
+    #include "ssd1306.h"
+
+    // init in one step
+    #define DisplayInitStep() (Ssd1306Init(), DISPLAY_INIT_DONE)
+    // fixed mounting
+    #define SetRotation(rotation) ((void) 0)
+
+  #elif DISPLAY_BACKEND == DISPLAY_NULL
+
+    #include <stdint.h>
+
+    // Colors
+    #define BLACK   0x0000
+    #define WHITE   0xFFFF
+    #define RED     0xF000
+
+    // size of ST7735 in landscape
+    #define MAX_X   160
+    #define MAX_Y   128
+    #define SIZE_X  MAX_X - 1
+    #define SIZE_Y  MAX_Y - 1
+    #define CHARS_COLS_LEN 5
+    #define CHARS_ROWS_LEN 8
+
+    /** @enum Font sizes */
+    typedef enum {
+      X1 = 0x11,
+      X2 = 0x21,
+      X3 = 0x22
+    } ESizes;
+
+    // nothing sent, arguments not evaluated
+    #define DisplayInitStep() DISPLAY_INIT_DONE
+    #define SetRotation(rotation) ((void) 0)
+    #define ClearScreen(color) ((void) 0)
+    #define UpdateScreen() ((void) 0)
+    #define SetPosition(x, y) ((void) 0)
+    #define DrawPixel(x, y, color) ((void) 0)
+    #define DrawChar(character, color, size) ((void) 0)
+    #define DrawString(str, color, size) ((void) 0)
+    #define DrawCharOpaque(character, color, background, size) ((void) 0)
+    #define DrawStringOpaque(str, color, background, size) ((void) 0)
+    #define DrawLine(x1, x2, y1, y2, color) ((void) 0)
+    #define DrawLineHorizontal(xs, xe, y, color) ((void) 0)
+    #define DrawLineVertical(x, ys, ye, color) ((void) 0)
+    #define DrawRectangle(xs, xe, ys, ye, color) ((void) 0)
+
+  #else
+    #error "DISPLAY_BACKEND unknown"
+  #endif
+
+#endif
@@ -0,0 +1,113 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        Font 5x8 shared by display drivers
+ * -------------------------------------------------------------+ 
+ *
+ * @file        font.h
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+#ifndef __FONT_H__
+#define __FONT_H__
+
+  /** @def Charset 5x8 - G(column 0, .., column 4), bit 0 top row */
+  #define FONT_5X8(G) \
+    G(0x00, 0x00, 0x00, 0x00, 0x00) /* 20 space */ \
+    G(0x00, 0x00, 0x5f, 0x00, 0x00) /* 21 ! */ \
+    G(0x00, 0x07, 0x00, 0x07, 0x00) /* 22 " */ \
+    G(0x14, 0x7f, 0x14, 0x7f, 0x14) /* 23 # */ \
+    G(0x24, 0x2a, 0x7f, 0x2a, 0x12) /* 24 $ */ \
+    G(0x23, 0x13, 0x08, 0x64, 0x62) /* 25 % */ \
+    G(0x36, 0x49, 0x55, 0x22, 0x50) /* 26 & */ \
+    G(0x00, 0x05, 0x03, 0x00, 0x00) /* 27 ' */ \
+    G(0x00, 0x1c, 0x22, 0x41, 0x00) /* 28 ( */ \
+    G(0x00, 0x41, 0x22, 0x1c, 0x00) /* 29 ) */ \
+    G(0x14, 0x08, 0x3e, 0x08, 0x14) /* 2a * */ \
+    G(0x08, 0x08, 0x3e, 0x08, 0x08) /* 2b + */ \
+    G(0x00, 0x50, 0x30, 0x00, 0x00) /* 2c , */ \
+    G(0x08, 0x08, 0x08, 0x08, 0x08) /* 2d - */ \
+    G(0x00, 0x60, 0x60, 0x00, 0x00) /* 2e . */ \
+    G(0x20, 0x10, 0x08, 0x04, 0x02) /* 2f / */ \
+    G(0x3e, 0x51, 0x49, 0x45, 0x3e) /* 30 0 */ \
+    G(0x00, 0x42, 0x7f, 0x40, 0x00) /* 31 1 */ \
+    G(0x42, 0x61, 0x51, 0x49, 0x46) /* 32 2 */ \
+    G(0x21, 0x41, 0x45, 0x4b, 0x31) /* 33 3 */ \
+    G(0x18, 0x14, 0x12, 0x7f, 0x10) /* 34 4 */ \
+    G(0x27, 0x45, 0x45, 0x45, 0x39) /* 35 5 */ \
+    G(0x3c, 0x4a, 0x49, 0x49, 0x30) /* 36 6 */ \
+    G(0x01, 0x71, 0x09, 0x05, 0x03) /* 37 7 */ \
+    G(0x36, 0x49, 0x49, 0x49, 0x36) /* 38 8 */ \
+    G(0x06, 0x49, 0x49, 0x29, 0x1e) /* 39 9 */ \
+    G(0x00, 0x36, 0x36, 0x00, 0x00) /* 3a : */ \
+    G(0x00, 0x56, 0x36, 0x00, 0x00) /* 3b ; */ \
+    G(0x08, 0x14, 0x22, 0x41, 0x00) /* 3c < */ \
+    G(0x14, 0x14, 0x14, 0x14, 0x14) /* 3d = */ \
+    G(0x00, 0x41, 0x22, 0x14, 0x08) /* 3e > */ \
+    G(0x02, 0x01, 0x51, 0x09, 0x06) /* 3f ? */ \
+    G(0x32, 0x49, 0x79, 0x41, 0x3e) /* 40 @ */ \
+    G(0x7e, 0x11, 0x11, 0x11, 0x7e) /* 41 A */ \
+    G(0x7f, 0x49, 0x49, 0x49, 0x36) /* 42 B */ \
+    G(0x3e, 0x41, 0x41, 0x41, 0x22) /* 43 C */ \
+    G(0x7f, 0x41, 0x41, 0x22, 0x1c) /* 44 D */ \
+    G(0x7f, 0x49, 0x49, 0x49, 0x41) /* 45 E */ \
+    G(0x7f, 0x09, 0x09, 0x09, 0x01) /* 46 F */ \
+    G(0x3e, 0x41, 0x49, 0x49, 0x7a) /* 47 G */ \
+    G(0x7f, 0x08, 0x08, 0x08, 0x7f) /* 48 H */ \
+    G(0x00, 0x41, 0x7f, 0x41, 0x00) /* 49 I */ \
+    G(0x20, 0x40, 0x41, 0x3f, 0x01) /* 4a J */ \
+    G(0x7f, 0x08, 0x14, 0x22, 0x41) /* 4b K */ \
+    G(0x7f, 0x40, 0x40, 0x40, 0x40) /* 4c L */ \
+    G(0x7f, 0x02, 0x0c, 0x02, 0x7f) /* 4d M */ \
+    G(0x7f, 0x04, 0x08, 0x10, 0x7f) /* 4e N */ \
+    G(0x3e, 0x41, 0x41, 0x41, 0x3e) /* 4f O */ \
+    G(0x7f, 0x09, 0x09, 0x09, 0x06) /* 50 P */ \
+    G(0x3e, 0x41, 0x51, 0x21, 0x5e) /* 51 Q */ \
+    G(0x7f, 0x09, 0x19, 0x29, 0x46) /* 52 R */ \
+    G(0x46, 0x49, 0x49, 0x49, 0x31) /* 53 S */ \
+    G(0x01, 0x01, 0x7f, 0x01, 0x01) /* 54 T */ \
+    G(0x3f, 0x40, 0x40, 0x40, 0x3f) /* 55 U */ \
+    G(0x1f, 0x20, 0x40, 0x20, 0x1f) /* 56 V */ \
+    G(0x3f, 0x40, 0x38, 0x40, 0x3f) /* 57 W */ \
+    G(0x63, 0x14, 0x08, 0x14, 0x63) /* 58 X */ \
+    G(0x07, 0x08, 0x70, 0x08, 0x07) /* 59 Y */ \
+    G(0x61, 0x51, 0x49, 0x45, 0x43) /* 5a Z */ \
+    G(0x00, 0x7f, 0x41, 0x41, 0x00) /* 5b [ */ \
+    G(0x02, 0x04, 0x08, 0x10, 0x20) /* 5c backslash */ \
+    G(0x00, 0x41, 0x41, 0x7f, 0x00) /* 5d ] */ \
+    G(0x04, 0x02, 0x01, 0x02, 0x04) /* 5e ^ */ \
+    G(0x40, 0x40, 0x40, 0x40, 0x40) /* 5f _ */ \
+    G(0x00, 0x01, 0x02, 0x04, 0x00) /* 60 ` */ \
+    G(0x20, 0x54, 0x54, 0x54, 0x78) /* 61 a */ \
+    G(0x7f, 0x48, 0x44, 0x44, 0x38) /* 62 b */ \
+    G(0x38, 0x44, 0x44, 0x44, 0x20) /* 63 c */ \
+    G(0x38, 0x44, 0x44, 0x48, 0x7f) /* 64 d */ \
+    G(0x38, 0x54, 0x54, 0x54, 0x18) /* 65 e */ \
+    G(0x08, 0x7e, 0x09, 0x01, 0x02) /* 66 f */ \
+    G(0x0c, 0x52, 0x52, 0x52, 0x3e) /* 67 g */ \
+    G(0x7f, 0x08, 0x04, 0x04, 0x78) /* 68 h */ \
+    G(0x00, 0x44, 0x7d, 0x40, 0x00) /* 69 i */ \
+    G(0x20, 0x40, 0x44, 0x3d, 0x00) /* 6a j */ \
+    G(0x7f, 0x10, 0x28, 0x44, 0x00) /* 6b k */ \
+    G(0x00, 0x41, 0x7f, 0x40, 0x00) /* 6c l */ \
+    G(0x7c, 0x04, 0x18, 0x04, 0x78) /* 6d m */ \
+    G(0x7c, 0x08, 0x04, 0x04, 0x78) /* 6e n */ \
+    G(0x38, 0x44, 0x44, 0x44, 0x38) /* 6f o */ \
+    G(0x7c, 0x14, 0x14, 0x14, 0x08) /* 70 p */ \
+    G(0x08, 0x14, 0x14, 0x14, 0x7c) /* 71 q */ \
+    G(0x7c, 0x08, 0x04, 0x04, 0x08) /* 72 r */ \
+    G(0x48, 0x54, 0x54, 0x54, 0x20) /* 73 s */ \
+    G(0x04, 0x3f, 0x44, 0x40, 0x20) /* 74 t */ \
+    G(0x3c, 0x40, 0x40, 0x20, 0x7c) /* 75 u */ \
+    G(0x1c, 0x20, 0x40, 0x20, 0x1c) /* 76 v */ \
+    G(0x3c, 0x40, 0x30, 0x40, 0x3c) /* 77 w */ \
+    G(0x44, 0x28, 0x10, 0x28, 0x44) /* 78 x */ \
+    G(0x0c, 0x50, 0x50, 0x50, 0x3c) /* 79 y */ \
+    G(0x44, 0x64, 0x54, 0x4c, 0x44) /* 7a z */ \
+    G(0x00, 0x08, 0x36, 0x41, 0x00) /* 7b { */ \
+    G(0x00, 0x00, 0x7f, 0x00, 0x00) /* 7c | */ \
+    G(0x00, 0x41, 0x36, 0x08, 0x00) /* 7d } */ \
+    G(0x10, 0x08, 0x08, 0x10, 0x08) /* 7e ~ */ \
+    G(0x00, 0x00, 0x00, 0x00, 0x00) /* 7f */
+
+#endif
@@ -0,0 +1,437 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Host model of ST7735 controller - MADCTL, COLMOD, PPM
+ * -------------------------------------------------------------+
+ *
+ * @file        hostlcd.c
+ * @tested      Linux, gcc
+ * -------------------------------------------------------------+
+ */
+
+// include libraries
+#include <stdio.h>
+#include "hostlcd.h"
+#include "st7735.h"
+
+/** @var SPI registers */
+volatile uint8_t hostRegister;
+/** @var Port of display pins */
+volatile uint8_t hostPort;
+/** @var Status register - interrupts enabled */
+volatile uint8_t hostSreg = (1 << SREG_I);
+/** @var Simulated CPU cycles */
+uint32_t hostCycles = 0;
+/** @var Cycles of SPI interrupts */
+uint32_t hostIsrCycles = 0;
+/** @var End of transfer in cycles */
+static uint32_t hostSpiEnd = 0;
+/** @var Byte in transfer */
+static uint8_t hostSpiBusy = 0;
+/** @var Bytes received */
+uint32_t hostLcdBytes = 0;
+/** @var Pixels written */
+uint32_t hostLcdPixels = 0;
+/** @var MADCTL writes changing ML, RGB, MH of first MADCTL */
+uint32_t hostLcdBaseChanges = 0;
+
+/** @var Display memory 565 - rows x columns */
+static uint16_t hostLcdMemory[ST7735_ROWS][ST7735_COLS];
+/** @var Last command */
+static uint8_t hostLcdCommand = NOP;
+/** @var Data bytes after command */
+static uint32_t hostLcdArgument = 0;
+/** @var Window - columns, rows */
+static uint8_t hostLcdWindow[4];
+/** @var Position in window */
+static uint8_t hostLcdX = 0;
+static uint8_t hostLcdY = 0;
+/** @var Bytes of pixel (pair in 12 bits mode) */
+static uint8_t hostLcdByte[2];
+/** @var Memory access control, ML, RGB, MH of first write (0xFF none) */
+uint8_t hostLcdMadctl = 0;
+static uint8_t hostLcdBase = 0xFF;
+/** @var 12 bits color mode */
+static uint8_t hostLcdColor12 = 0;
+
+/**
+ * @desc    Window position to memory - MV swaps, MX / MY mirror
+ *
+ * @param   uint8_t x column of window
+ * @param   uint8_t y row of window
+ *
+ * @return  uint16_t * pixel in memory, NULL out of memory
+ */
+static uint16_t *HostLcdAddress(uint8_t x, uint8_t y)
+{
+  uint8_t column = x;
+  uint8_t row = y;
+
+  // MV - row / column exchange
+  if (hostLcdMadctl & 0x20) {
+    column = y;
+    row = x;
+  }
+  // out of memory
+  if ((column >= ST7735_COLS) || (row >= ST7735_ROWS)) {
+    return NULL;
+  }
+  // MX - column address order
+  if (hostLcdMadctl & 0x40) {
+    column = ST7735_COLS - 1 - column;
+  }
+  // MY - row address order
+  if (hostLcdMadctl & 0x80) {
+    row = ST7735_ROWS - 1 - row;
+  }
+  // pixel
+  return &hostLcdMemory[row][column];
+}
+
+/**
+ * @desc    Store pixel at position, move to next in window
+ *
+ * @param   uint16_t color 565
+ *
+ * @return  void
+ */
+static void HostLcdStore(uint16_t color)
+{
+  uint16_t *pixel = HostLcdAddress(hostLcdX, hostLcdY);
+
+  // store
+  if (pixel) {
+    *pixel = color;
+  }
+  hostLcdPixels++;
+  // next column, next row at end of window
+  if (hostLcdX++ >= hostLcdWindow[1]) {
+    hostLcdX = hostLcdWindow[0];
+    if (hostLcdY++ >= hostLcdWindow[3]) {
+      hostLcdY = hostLcdWindow[2];
+    }
+  }
+}
+
+/**
+ * @desc    Color 444 to 565
+ *
+ * @param   uint16_t color 444
+ *
+ * @return  uint16_t color 565
+ */
+static uint16_t HostLcd444(uint16_t color)
+{
+  uint8_t r = (color >> 8) & 0x0F;
+  uint8_t g = (color >> 4) & 0x0F;
+  uint8_t b = color & 0x0F;
+
+  // components widened, top bits repeated
+  return ((r << 1 | r >> 3) << 11) | ((g << 2 | g >> 2) << 5) | (b << 1 | b >> 3);
+}
+
+/**
+ * @desc    Command byte - D/C low
+ *
+ * @param   uint8_t command
+ *
+ * @return  void
+ */
+void HostLcdCommand(uint8_t command)
+{
+  // counter
+  hostLcdBytes++;
+  // new command
+  hostLcdCommand = command;
+  hostLcdArgument = 0;
+  // memory write from window start
+  if (command == RAMWR) {
+    hostLcdX = hostLcdWindow[0];
+    hostLcdY = hostLcdWindow[2];
+  }
+}
+
+/**
+ * @desc    Data byte - D/C high
+ *
+ * @param   uint8_t data
+ *
+ * @return  void
+ */
+void HostLcdData(uint8_t data)
+{
+  // counter
+  hostLcdBytes++;
+  // column / row start and end - low bytes of 16 bits arguments
+  if ((hostLcdCommand == CASET) || (hostLcdCommand == RASET)) {
+    if ((hostLcdArgument & 1) && (hostLcdArgument < 4)) {
+      hostLcdWindow[((hostLcdCommand == RASET) << 1) + (hostLcdArgument >> 1)] = data;
+    }
+  // memory access control
+  } else if (hostLcdCommand == MADCTL) {
+    hostLcdMadctl = data;
+    // rotation keeps panel bits of init list
+    if (hostLcdBase == 0xFF) {
+      hostLcdBase = data & 0x1C;
+    } else if ((data & 0x1C) != hostLcdBase) {
+      hostLcdBaseChanges++;
+    }
+  // 0x03 - 12 bits, 0x05 - 16 bits
+  } else if (hostLcdCommand == COLMOD) {
+    hostLcdColor12 = ((data & 0x07) == 0x03);
+  // 12 bits - RRRRGGGG BBBBRRRR GGGGBBBB
+  } else if ((hostLcdCommand == RAMWR) && hostLcdColor12) {
+    switch (hostLcdArgument % 3) {
+      case 0:
+        hostLcdByte[0] = data;
+        break;
+      case 1:
+        hostLcdByte[1] = data;
+        // first of pair complete
+        HostLcdStore(HostLcd444((hostLcdByte[0] << 4) | (data >> 4)));
+        break;
+      default:
+        // second of pair
+        HostLcdStore(HostLcd444(((hostLcdByte[1] & 0x0F) << 8) | data));
+        break;
+    }
+  // 16 bits - high byte first
+  } else if (hostLcdCommand == RAMWR) {
+    if (!(hostLcdArgument & 1)) {
+      hostLcdByte[0] = data;
+    } else {
+      HostLcdStore((hostLcdByte[0] << 8) | data);
+    }
+  }
+  // next argument
+  hostLcdArgument++;
+}
+
+/**
+ * @desc    SPI interrupt of blocking build - nothing queued,
+ *          queued build defines its own
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+__attribute__((weak)) void HostSpiVector(void)
+{
+}
+
+/**
+ * @desc    Transfer ends - interrupt runs if enabled, flag stays
+ *          set for polling otherwise
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+static void HostSpiEnd(void)
+{
+  // time of end
+  if ((int32_t) (hostSpiEnd - hostCycles) > 0) {
+    hostCycles = hostSpiEnd;
+  }
+  // polled
+  if (!(hostSreg & (1 << SREG_I))) {
+    return;
+  }
+  hostSpiBusy = 0;
+  // handler with interrupts disabled
+  hostSreg &= ~(1 << SREG_I);
+  hostCycles += HOST_ISR_CYCLES;
+  hostIsrCycles += HOST_ISR_CYCLES;
+  HostSpiVector();
+  hostSreg |= (1 << SREG_I);
+}
+
+/**
+ * @desc    SPI byte of queued output - to controller now,
+ *          transfer complete after 8 * ST7735_SPI_DIV cycles
+ *
+ * @param   uint8_t byte
+ * @param   uint8_t D/C - 0 command, other data
+ *
+ * @return  void
+ */
+void HostSpiSend(uint8_t data, uint8_t dc)
+{
+  // controller
+  if (dc) {
+    HostLcdData(data);
+  } else {
+    HostLcdCommand(data);
+  }
+  // transfer
+  hostSpiEnd = hostCycles + 8 * ST7735_SPI_DIV;
+  hostSpiBusy = 1;
+}
+
+/**
+ * @desc    Transfer complete polled with interrupts disabled - time
+ *          moves to end of transfer, flag cleared
+ *
+ * @param   void
+ *
+ * @return  uint8_t 1 byte was in transfer
+ */
+uint8_t HostSpiDone(void)
+{
+  // nothing sent
+  if (!hostSpiBusy) {
+    return 0;
+  }
+  // wait for end
+  HostSpiEnd();
+  hostSpiBusy = 0;
+  return 1;
+}
+
+/**
+ * @desc    CPU waits - time moves to end of transfer, interrupt
+ *          runs if enabled
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+void HostSpiWait(void)
+{
+  // nothing to wait for
+  if (!hostSpiBusy) {
+    return;
+  }
+  HostSpiEnd();
+}
+
+/**
+ * @desc    Work of main program - cycles pass, interrupts of
+ *          transfers ending meanwhile run and delay the work
+ *
+ * @param   uint32_t cycles of work
+ *
+ * @return  void
+ */
+void HostCpuRun(uint32_t cycles)
+{
+  uint32_t end = hostCycles + cycles;
+  uint32_t isr;
+
+  // transfers ending before work is done
+  while (hostSpiBusy && (hostSreg & (1 << SREG_I)) && ((int32_t) (end - hostSpiEnd) >= 0)) {
+    isr = hostIsrCycles;
+    HostSpiEnd();
+    // time of interrupt moves end of work
+    end += hostIsrCycles - isr;
+  }
+  hostCycles = end;
+}
+
+/**
+ * @desc    Byte in transfer
+ *
+ * @param   void
+ *
+ * @return  uint8_t 1 busy
+ */
+uint8_t HostSpiBusy(void)
+{
+  return hostSpiBusy;
+}
+
+/**
+ * @desc    Color of pixel as seen through current MADCTL
+ *
+ * @param   uint8_t x
+ * @param   uint8_t y
+ *
+ * @return  uint16_t color 565
+ */
+uint16_t HostLcdPixel(uint8_t x, uint8_t y)
+{
+  uint16_t *pixel = HostLcdAddress(x, y);
+
+  // out of memory black
+  return pixel ? *pixel : 0;
+}
+
+/**
+ * @desc    Write display memory as binary PPM - columns x rows,
+ *          independent of MADCTL, so wrong rotation mapping shows
+ *
+ * @param   const char * file name
+ *
+ * @return  uint8_t 0 success
+ */
+uint8_t HostLcdDump(const char *name)
+{
+  FILE *file;
+  uint16_t color;
+  uint8_t x, y;
+
+  // open
+  if ((file = fopen(name, "wb")) == NULL) {
+    return 1;
+  }
+  // header
+  fprintf(file, "P6\n%u %u\n255\n", ST7735_COLS, ST7735_ROWS);
+  // pixels 565 to 888
+  for (y = 0; y < ST7735_ROWS; y++) {
+    for (x = 0; x < ST7735_COLS; x++) {
+      color = hostLcdMemory[y][x];
+      fputc(((color >> 11) & 0x1F) << 3, file);
+      fputc(((color >> 5) & 0x3F) << 2, file);
+      fputc((color & 0x1F) << 3, file);
+    }
+  }
+  // close
+  return fclose(file) ? 1 : 0;
+}
+
+/**
+ * @desc    Compare display memory with PPM at 565 precision
+ *
+ * @param   const char * file name
+ *
+ * @return  int32_t number of different pixels, -1 unreadable or other size
+ */
+int32_t HostLcdCompare(const char *name)
+{
+  FILE *file;
+  unsigned width, height, max;
+  int32_t differ = 0;
+  int r, g, b;
+  uint16_t color;
+  uint8_t x, y;
+
+  // open
+  if ((file = fopen(name, "rb")) == NULL) {
+    return -1;
+  }
+  // header of same size
+  if ((fscanf(file, "P6 %u %u %u", &width, &height, &max) != 3) || (fgetc(file) == EOF) ||
+      (width != ST7735_COLS) || (height != ST7735_ROWS) || (max != 255)) {
+    fclose(file);
+    return -1;
+  }
+  // pixels
+  for (y = 0; y < ST7735_ROWS; y++) {
+    for (x = 0; x < ST7735_COLS; x++) {
+      r = fgetc(file);
+      g = fgetc(file);
+      b = fgetc(file);
+      // short file
+      if (b == EOF) {
+        fclose(file);
+        return -1;
+      }
+      color = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+      if (color != hostLcdMemory[y][x]) {
+        differ++;
+      }
+    }
+  }
+  // close
+  fclose(file);
+  return differ;
+}
@@ -0,0 +1,180 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Host model of ST7735 controller - MADCTL, COLMOD, PPM
+ * -------------------------------------------------------------+
+ *
+ * @file        hostlcd.h
+ * @tested      Linux, gcc
+ * -------------------------------------------------------------+
+ */
+
+#include <stdint.h>
+#include "hostpgm.h"
+
+#ifndef __HOSTLCD_H__
+#define __HOSTLCD_H__
+
+  #if !defined(__AVR__)
+    // registers of SPI - written, never read back
+    extern volatile uint8_t hostRegister;
+    #define DDRB    hostRegister
+    #define SPCR    hostRegister
+    #define SPSR    hostRegister
+    #define SPDR    hostRegister
+    #define SPIE    7
+    #define SPE     6
+    #define MSTR    4
+    #define SPR1    1
+    #define SPR0    0
+    #define SPI2X   0
+    // port of display pins - D/C read back by queued output
+    extern volatile uint8_t hostPort;
+    #define PORTB   hostPort
+
+    // status register - global interrupt flag only
+    extern volatile uint8_t hostSreg;
+    #define SREG    hostSreg
+    #define SREG_I  7
+    #define cli()   (hostSreg &= ~(1 << SREG_I))
+    #define sei()   (hostSreg |= (1 << SREG_I))
+    #define ATOMIC_RESTORESTATE
+    #define ATOMIC_BLOCK(type) \
+      for (uint8_t hostSave = SREG, hostOnce = (cli(), 1); hostOnce; hostOnce = 0, SREG = hostSave)
+    // sleep till interrupt
+    #define SLEEP_MODE_IDLE 0
+    #define set_sleep_mode(mode)
+    #define sleep_enable()
+    #define sleep_disable()
+    #define sleep_cpu() HostSpiWait()
+    // interrupt handler - called by model when byte is sent
+    #define ISR(vector) void vector(void)
+    #define SPI_STC_vect HostSpiVector
+  #endif
+
+  // CPU cycles of SPI interrupt - entry, SpiPump, exit; estimate
+  // of avr-gcc -Os code, model only
+  #ifndef HOST_ISR_CYCLES
+    #define HOST_ISR_CYCLES 90
+  #endif
+
+  /** @var Simulated CPU cycles - SPI timing of queued output */
+  extern uint32_t hostCycles;
+  /** @var Cycles of SPI interrupts */
+  extern uint32_t hostIsrCycles;
+
+  /** @var Bytes received, commands and data */
+  extern uint32_t hostLcdBytes;
+  /** @var Pixels written to memory */
+  extern uint32_t hostLcdPixels;
+  /** @var MADCTL writes changing ML, RGB, MH of first MADCTL */
+  extern uint32_t hostLcdBaseChanges;
+  /** @var Last MADCTL written */
+  extern uint8_t hostLcdMadctl;
+
+  /**
+   * @desc    Command byte - D/C low
+   *
+   * @param   uint8_t command
+   *
+   * @return  void
+   */
+  void HostLcdCommand(uint8_t);
+
+  /**
+   * @desc    Data byte - D/C high
+   *
+   * @param   uint8_t data
+   *
+   * @return  void
+   */
+  void HostLcdData(uint8_t);
+
+  /**
+   * @desc    SPI interrupt handler - ISR(SPI_STC_vect) of queued output
+   *
+   * @param   void
+   *
+   * @return  void
+   */
+  void HostSpiVector(void);
+
+  /**
+   * @desc    SPI byte of queued output - to controller now,
+   *          transfer complete after 8 * ST7735_SPI_DIV cycles
+   *
+   * @param   uint8_t byte
+   * @param   uint8_t D/C - 0 command, other data
+   *
+   * @return  void
+   */
+  void HostSpiSend(uint8_t, uint8_t);
+
+  /**
+   * @desc    Transfer complete polled with interrupts disabled - time
+   *          moves to end of transfer, flag cleared
+   *
+   * @param   void
+   *
+   * @return  uint8_t 1 byte was in transfer
+   */
+  uint8_t HostSpiDone(void);
+
+  /**
+   * @desc    CPU waits - time moves to end of transfer, interrupt
+   *          runs if enabled
+   *
+   * @param   void
+   *
+   * @return  void
+   */
+  void HostSpiWait(void);
+
+  /**
+   * @desc    Work of main program - cycles pass, interrupts of
+   *          transfers ending meanwhile run and delay the work
+   *
+   * @param   uint32_t cycles of work
+   *
+   * @return  void
+   */
+  void HostCpuRun(uint32_t);
+
+  /**
+   * @desc    Byte in transfer
+   *
+   * @param   void
+   *
+   * @return  uint8_t 1 busy
+   */
+  uint8_t HostSpiBusy(void);
+
+  /**
+   * @desc    Color of pixel as seen through current MADCTL
+   *
+   * @param   uint8_t x
+   * @param   uint8_t y
+   *
+   * @return  uint16_t color 565
+   */
+  uint16_t HostLcdPixel(uint8_t, uint8_t);
+
+  /**
+   * @desc    Write display memory as binary PPM - columns x rows,
+   *          independent of MADCTL, so wrong rotation mapping shows
+   *
+   * @param   const char * file name
+   *
+   * @return  uint8_t 0 success
+   */
+  uint8_t HostLcdDump(const char *);
+
+  /**
+   * @desc    Compare display memory with PPM at 565 precision
+   *
+   * @param   const char * file name
+   *
+   * @return  int32_t number of different pixels, -1 unreadable or other size
+   */
+  int32_t HostLcdCompare(const char *);
+
+#endif
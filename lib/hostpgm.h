@@ -0,0 +1,28 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Host stand in of avr/pgmspace.h - flash is RAM
+ * -------------------------------------------------------------+
+ *
+ * @file        hostpgm.h
+ * @tested      Linux, gcc
+ * -------------------------------------------------------------+
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef __HOSTPGM_H__
+#define __HOSTPGM_H__
+
+  #if !defined(__AVR__)
+    // flash access is plain access on host
+    #define PROGMEM
+    #define PSTR(string) (string)
+    #define pgm_read_byte(address) (*(const uint8_t *) (address))
+    #define pgm_read_word(address) (*(const uint16_t *) (address))
+    #define pgm_read_ptr(address) (*(void * const *) (address))
+    #define strcmp_P(string, flash) strcmp((string), (flash))
+    #define strcpy_P(string, flash) strcpy((string), (flash))
+  #endif
+
+#endif
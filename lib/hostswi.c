@@ -0,0 +1,187 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Host model of software I2C buses - slaves, time
+ * -------------------------------------------------------------+
+ *
+ * @file        hostswi.c
+ * @tested      Linux, gcc
+ * -------------------------------------------------------------+
+ */
+
+// include libraries
+#include "hostswi.h"
+
+// buses of port
+#define HOST_SWI_BUSES 4
+
+/** @enum State of slave */
+typedef enum {
+  HOST_SWI_IDLE,
+  HOST_SWI_ADDRESS,
+  HOST_SWI_ACK
+} EHostSwiState;
+
+/** @struct Slaves of one bus */
+typedef struct {
+  // acknowledged addresses
+  uint8_t devices[16];
+  // SCL held low
+  uint8_t stuck;
+  // SDA pulled low by slave
+  uint8_t sda;
+  // transfer
+  EHostSwiState state;
+  uint8_t bits;
+  uint8_t shift;
+  uint8_t clocked;
+} THostSwiBus;
+
+/** @var Port and direction */
+volatile uint8_t hostSwiPort = 0;
+volatile uint8_t hostSwiDdr = 0;
+/** @var Time in us */
+double hostSwiTime = 0;
+/** @var Direction writes */
+uint32_t hostSwiWrites = 0;
+
+/** @var Buses */
+static THostSwiBus hostSwiBuses[HOST_SWI_BUSES];
+/** @var Levels before last change */
+static uint8_t hostSwiLevels = 0xFF;
+
+/**
+ * @desc    Slave on bus acknowledges address
+ *
+ * @param   uint8_t bus 0 .. 3
+ * @param   uint8_t address
+ *
+ * @return  void
+ */
+void HostSwiDevice(uint8_t bus, uint8_t address)
+{
+  hostSwiBuses[bus].devices[(address >> 3) & 0x0F] |= (1 << (address & 0x07));
+}
+
+/**
+ * @desc    SCL of bus held low by slave
+ *
+ * @param   uint8_t bus 0 .. 3
+ * @param   uint8_t 1 held low, 0 released
+ *
+ * @return  void
+ */
+void HostSwiStuck(uint8_t bus, uint8_t stuck)
+{
+  hostSwiBuses[bus].stuck = stuck;
+  hostSwiLevels = HostSwiPin();
+}
+
+/**
+ * @desc    Levels of lines - released lines high by pull-up
+ *          unless master or slave pulls them low
+ *
+ * @param   void
+ *
+ * @return  uint8_t
+ */
+uint8_t HostSwiPin(void)
+{
+  uint8_t levels = (uint8_t) ~hostSwiDdr;
+  uint8_t bus;
+
+  // slaves
+  for (bus = 0; bus < HOST_SWI_BUSES; bus++) {
+    if (hostSwiBuses[bus].sda) {
+      levels &= (uint8_t) ~(1 << bus);
+    }
+    if (hostSwiBuses[bus].stuck) {
+      levels &= (uint8_t) ~(1 << (bus + 4));
+    }
+  }
+  return levels;
+}
+
+/**
+ * @desc    Edges of one bus - START, address bits, ACK, STOP
+ *
+ * @param   THostSwiBus *
+ * @param   uint8_t SDA before, after
+ * @param   uint8_t SCL before, after
+ *
+ * @return  void
+ */
+static void HostSwiEdge(THostSwiBus *bus, uint8_t sda0, uint8_t sda1, uint8_t scl0, uint8_t scl1)
+{
+  // START / STOP - SDA changes while SCL high
+  if (scl0 && scl1 && (sda0 != sda1)) {
+    bus->state = sda1 ? HOST_SWI_IDLE : HOST_SWI_ADDRESS;
+    bus->bits = 0;
+    bus->shift = 0;
+    bus->sda = 0;
+    return;
+  }
+  // SCL rising - bit sampled
+  if (!scl0 && scl1) {
+    if ((bus->state == HOST_SWI_ADDRESS) && (bus->bits < 8)) {
+      bus->shift = (bus->shift << 1) | sda1;
+      bus->bits++;
+    } else if (bus->state == HOST_SWI_ACK) {
+      bus->clocked = 1;
+    }
+    return;
+  }
+  // SCL falling - slave changes SDA
+  if (scl0 && !scl1) {
+    // address with R/W complete - ACK if present
+    if ((bus->state == HOST_SWI_ADDRESS) && (bus->bits == 8)) {
+      if (bus->devices[bus->shift >> 4] & (1 << ((bus->shift >> 1) & 0x07))) {
+        bus->state = HOST_SWI_ACK;
+        bus->clocked = 0;
+        bus->sda = 1;
+      } else {
+        bus->state = HOST_SWI_IDLE;
+      }
+    // ACK clocked - released, data not modelled
+    } else if ((bus->state == HOST_SWI_ACK) && bus->clocked) {
+      bus->state = HOST_SWI_IDLE;
+      bus->sda = 0;
+    }
+  }
+}
+
+/**
+ * @desc    Drive lines - 1 in direction register pulls line low
+ *
+ * @param   uint8_t direction register
+ *
+ * @return  void
+ */
+void HostSwiDrive(uint8_t ddr)
+{
+  uint8_t before = hostSwiLevels;
+  uint8_t after;
+  uint8_t bus;
+
+  hostSwiDdr = ddr;
+  hostSwiWrites++;
+  after = HostSwiPin();
+  // every bus sees its own lines
+  for (bus = 0; bus < HOST_SWI_BUSES; bus++) {
+    HostSwiEdge(&hostSwiBuses[bus], (before >> bus) & 1, (after >> bus) & 1,
+      (before >> (bus + 4)) & 1, (after >> (bus + 4)) & 1);
+  }
+  // slave may have pulled SDA
+  hostSwiLevels = HostSwiPin();
+}
+
+/**
+ * @desc    Time passes
+ *
+ * @param   double us
+ *
+ * @return  void
+ */
+void HostSwiDelay(double us)
+{
+  hostSwiTime += us;
+}
@@ -0,0 +1,83 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Host model of software I2C buses - slaves, time
+ * -------------------------------------------------------------+
+ *
+ * @file        hostswi.h
+ * @tested      Linux, gcc
+ * -------------------------------------------------------------+
+ */
+
+#include <stdint.h>
+
+#ifndef __HOSTSWI_H__
+#define __HOSTSWI_H__
+
+  // port of buses - bus n: SDA on bit n, SCL on bit n + 4
+  extern volatile uint8_t hostSwiPort;
+  extern volatile uint8_t hostSwiDdr;
+  #define SWI_PORT hostSwiPort
+  #define SWI_DDR  hostSwiDdr
+  #define SWI_PIN  HostSwiPin()
+
+  // line changes go through model of slaves
+  #define SWI_LOW(mask)     { HostSwiDrive(hostSwiDdr | (mask)); }
+  #define SWI_RELEASE(mask) { HostSwiDrive(hostSwiDdr & (uint8_t) ~(mask)); }
+
+  // delay counts time of model
+  #define _delay_us(us) HostSwiDelay(us)
+
+  /** @var Time of model in us */
+  extern double hostSwiTime;
+  /** @var Writes of port direction */
+  extern uint32_t hostSwiWrites;
+
+  /**
+   * @desc    Slave on bus acknowledges address
+   *
+   * @param   uint8_t bus 0 .. 3
+   * @param   uint8_t address
+   *
+   * @return  void
+   */
+  void HostSwiDevice(uint8_t, uint8_t);
+
+  /**
+   * @desc    SCL of bus held low by slave
+   *
+   * @param   uint8_t bus 0 .. 3
+   * @param   uint8_t 1 held low, 0 released
+   *
+   * @return  void
+   */
+  void HostSwiStuck(uint8_t, uint8_t);
+
+  /**
+   * @desc    Drive lines - 1 in direction register pulls line low
+   *
+   * @param   uint8_t direction register
+   *
+   * @return  void
+   */
+  void HostSwiDrive(uint8_t);
+
+  /**
+   * @desc    Levels of lines - released lines high by pull-up
+   *          unless master or slave pulls them low
+   *
+   * @param   void
+   *
+   * @return  uint8_t
+   */
+  uint8_t HostSwiPin(void);
+
+  /**
+   * @desc    Time passes
+   *
+   * @param   double us
+   *
+   * @return  void
+   */
+  void HostSwiDelay(double);
+
+#endif
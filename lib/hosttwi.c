@@ -0,0 +1,486 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Host model of TWI master - devices, switches, other master
+ * -------------------------------------------------------------+
+ *
+ * @file        hosttwi.c
+ * @tested      Linux, gcc
+ * -------------------------------------------------------------+
+ */
+
+// include libraries
+#include <math.h>
+#include "twi.h"
+
+/** @var Registers */
+volatile uint8_t hostTwcr = 0;
+volatile uint8_t hostTwsr = 0xF8;
+volatile uint8_t hostTwbr = 0;
+volatile uint8_t hostTwdr = 0;
+volatile uint8_t hostTwar = 0;
+volatile uint16_t hostTcnt1 = 0;
+volatile uint8_t hostTimer = 0;
+/** @var Time in us */
+double hostTwiTime = 0;
+
+// max switches of model
+#define HOST_TWI_SWITCHES 8
+
+/** @struct Switch (TCA9548A) - control register, devices per channel */
+typedef struct {
+  uint8_t address;
+  uint8_t control;
+  uint8_t channels[8][TWI_BITMAP_SIZE];
+} THostSwitch;
+
+/** @var Acknowledging devices */
+static uint8_t hostTwiDevices[TWI_BITMAP_SIZE];
+/** @var Switches */
+static THostSwitch hostTwiSwitches[HOST_TWI_SWITCHES];
+static uint8_t hostTwiSwitchCount = 0;
+/** @var Switch addressed by transfer, NULL other device */
+static THostSwitch *hostTwiTarget = NULL;
+/** @var Data bytes written to devices other than switches */
+uint32_t hostTwiWrites = 0;
+/** @var Device with receiver, receiver */
+static uint8_t hostTwiRxAddress = 0;
+static THostTwiReceive hostTwiReceive = NULL;
+/** @var Receiver of transfer - 0 none, 1 first byte next, 2 following */
+static uint8_t hostTwiRx = 0;
+/** @var Scanner transfer - 0 idle, 1 address next, 2 data */
+static uint8_t hostTwiPhase = 0;
+/** @var Scanner released bus */
+static double hostTwiFree = 0;
+/** @var Scanner and other master started at same STOP */
+static uint8_t hostTwiContend = 0;
+
+/** @var Other master - transactions per us, length, next request, end of transaction */
+static double otherRate = 0;
+static double otherLength = 0;
+static double otherNext = 0;
+static double otherEnd = 0;
+/** @var Requests of other master waiting for bus */
+static uint32_t otherQueue = 0;
+/** @var Share of other master transactions addressing own slave */
+static double otherSlave = 0;
+/** @var Own slave addressed by winner - SLA+R/W, 0 none */
+static uint8_t otherAddressed = 0;
+/** @var Transfers with own slave served by ISR */
+uint32_t hostTwiServed = 0;
+/** @var Random state */
+static uint32_t otherRandom = 1;
+
+/**
+ * @desc    Random number - xorshift
+ *
+ * @param   void
+ *
+ * @return  uint32_t
+ */
+static uint32_t HostTwiRandom(void)
+{
+  otherRandom ^= otherRandom << 13;
+  otherRandom ^= otherRandom >> 17;
+  otherRandom ^= otherRandom << 5;
+  return otherRandom;
+}
+
+/**
+ * @desc    Time to next request of other master - exponential
+ *
+ * @param   void
+ *
+ * @return  double us
+ */
+static double HostTwiGap(void)
+{
+  return -log((HostTwiRandom() + 1.0) / 4294967297.0) / otherRate;
+}
+
+/**
+ * @desc    Bit time at TWBR, prescaler
+ *
+ * @param   void
+ *
+ * @return  double us
+ */
+static double HostTwiBit(void)
+{
+  return (16.0 + 2.0 * hostTwbr * (1 << (2 * (hostTwsr & 0x03)))) / (_FCPU / 1000000.0);
+}
+
+/**
+ * @desc    Time passes, Timer1 follows
+ *
+ * @param   double us
+ *
+ * @return  void
+ */
+void HostTwiDelay(double us)
+{
+  hostTwiTime += us;
+  hostTcnt1 = (uint16_t) (uint32_t) (hostTwiTime * TWI_TICKS_PER_US);
+}
+
+/**
+ * @desc    Transactions of other master till time, bus free of
+ *          scanner meanwhile
+ *
+ * @param   double us
+ *
+ * @return  void
+ */
+static void HostTwiOther(double till)
+{
+  double start;
+
+  while (otherRate > 0) {
+    start = otherEnd;
+    // next request
+    if (!otherQueue) {
+      if (otherNext > till) {
+        return;
+      }
+      otherQueue = 1;
+      start = (otherNext > start) ? otherNext : start;
+      otherNext += HostTwiGap();
+    }
+    // after scanner released bus
+    start = (hostTwiFree > start) ? hostTwiFree : start;
+    if (start > till) {
+      return;
+    }
+    otherEnd = start + otherLength;
+    otherQueue--;
+    // requests during transaction wait
+    while (otherNext < otherEnd) {
+      otherQueue++;
+      otherNext += HostTwiGap();
+    }
+  }
+}
+
+/**
+ * @desc    Device acknowledges address
+ *
+ * @param   uint8_t address
+ *
+ * @return  void
+ */
+void HostTwiDevice(uint8_t address)
+{
+  hostTwiDevices[(address >> 3) & 0x0F] |= (1 << (address & 0x07));
+}
+
+/**
+ * @desc    Device with receiver of written bytes - display model,
+ *          acknowledges address, data acknowledged by receiver
+ *
+ * @param   uint8_t address
+ * @param   THostTwiReceive
+ *
+ * @return  void
+ */
+void HostTwiReceiver(uint8_t address, THostTwiReceive receive)
+{
+  HostTwiDevice(address);
+  hostTwiRxAddress = address;
+  hostTwiReceive = receive;
+}
+
+/**
+ * @desc    Switch (TCA9548A) - acknowledges address, control register
+ *          written by data byte, read back; channels off at start
+ *
+ * @param   uint8_t address
+ *
+ * @return  void
+ */
+void HostTwiSwitch(uint8_t address)
+{
+  if (hostTwiSwitchCount < HOST_TWI_SWITCHES) {
+    hostTwiSwitches[hostTwiSwitchCount].address = address;
+    hostTwiSwitches[hostTwiSwitchCount++].control = 0x00;
+  }
+}
+
+/**
+ * @desc    Device on channel of switch - acknowledges while channel
+ *          enabled
+ *
+ * @param   uint8_t switch address
+ * @param   uint8_t channel 0 - 7
+ * @param   uint8_t device address
+ *
+ * @return  void
+ */
+void HostTwiBehind(uint8_t address, uint8_t channel, uint8_t device)
+{
+  uint8_t i;
+
+  for (i = 0; i < hostTwiSwitchCount; i++) {
+    if (hostTwiSwitches[i].address == address) {
+      hostTwiSwitches[i].channels[channel & 0x07][(device >> 3) & 0x0F] |= (1 << (device & 0x07));
+    }
+  }
+}
+
+/**
+ * @desc    Address acknowledged - upstream device, switch or device
+ *          on enabled channel; switch of transfer found
+ *
+ * @param   uint8_t address
+ *
+ * @return  uint8_t
+ */
+static uint8_t HostTwiAcks(uint8_t address)
+{
+  uint8_t ack = hostTwiDevices[address >> 3] & (1 << (address & 0x07));
+  uint8_t i, channel;
+
+  hostTwiTarget = NULL;
+  // receiver gets bytes of transfer
+  hostTwiRx = (hostTwiReceive && (address == hostTwiRxAddress)) ? 1 : 0;
+  for (i = 0; i < hostTwiSwitchCount; i++) {
+    if (hostTwiSwitches[i].address == address) {
+      hostTwiTarget = &hostTwiSwitches[i];
+      ack = 1;
+    }
+    for (channel = 0; channel < 8; channel++) {
+      if ((hostTwiSwitches[i].control & (1 << channel)) &&
+          (hostTwiSwitches[i].channels[channel][address >> 3] & (1 << (address & 0x07)))) {
+        ack = 1;
+      }
+    }
+  }
+  return ack;
+}
+
+/**
+ * @desc    Other master - transactions at random times, each holding
+ *          bus for length; addresses of its transactions random
+ *          over 0x08 - 0x77
+ *
+ * @param   double transactions per second, 0 none
+ * @param   double length of transaction in us
+ * @param   uint32_t seed
+ *
+ * @return  void
+ */
+void HostTwiMaster(double rate, double length, uint32_t seed)
+{
+  otherRate = rate / 1000000.0;
+  otherLength = length;
+  otherRandom = seed ? seed : 1;
+  otherQueue = 0;
+  otherEnd = hostTwiTime;
+  otherNext = hostTwiTime + ((rate > 0) ? HostTwiGap() : 0);
+}
+
+/**
+ * @desc    Other master addresses own slave - share of transactions
+ *          set by HostTwiSlave, own address from TWAR
+ *
+ * @param   void
+ *
+ * @return  uint8_t SLA+R/W of own slave, 0 other device
+ */
+static uint8_t HostTwiOwn(void)
+{
+  // no own slave or none addressed
+  if (!hostTwar || (otherSlave <= 0) || ((HostTwiRandom() + 1.0) / 4294967297.0 >= otherSlave)) {
+    return 0;
+  }
+  // write of register pointer or read of registers
+  return (hostTwar & 0xFE) | (HostTwiRandom() & 1);
+}
+
+/**
+ * @desc    Transfer of winner with own slave - ISR of twi.c (slave
+ *          armed by lost probe) gets statuses of whole transfer;
+ *          write sets register pointer 0, read takes bitmap
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+static void HostTwiServe(void)
+{
+  uint8_t i;
+
+  // SLA+W, register pointer, STOP
+  if (!(otherAddressed & 1)) {
+    hostTwsr = (hostTwsr & 0x03) | TWI_SR_ALMOA_ACK;
+    HostTwiVector();
+    hostTwdr = 0x00;
+    hostTwsr = (hostTwsr & 0x03) | TWI_SR_OA_DATA_ACK;
+    HostTwiVector();
+    hostTwsr = (hostTwsr & 0x03) | TWI_SR_STOP_RSTART;
+    HostTwiVector();
+  // SLA+R, bitmap, last byte NOT ACK
+  } else {
+    hostTwsr = (hostTwsr & 0x03) | TWI_ST_ALMOA_ACK;
+    HostTwiVector();
+    for (i = 1; i < TWI_BITMAP_SIZE; i++) {
+      hostTwsr = (hostTwsr & 0x03) | TWI_ST_DATA_ACK;
+      HostTwiVector();
+    }
+    hostTwsr = (hostTwsr & 0x03) | TWI_ST_DATA_NACK;
+    HostTwiVector();
+  }
+  otherAddressed = 0;
+  hostTwiServed++;
+}
+
+/**
+ * @desc    Other master addresses own slave (TWAR) in share of its
+ *          transactions
+ *
+ * @param   double share 0 - 1
+ *
+ * @return  void
+ */
+void HostTwiSlave(double share)
+{
+  otherSlave = share;
+}
+
+/**
+ * @desc    START - waits for STOP of other master, both start after
+ *          it if other master has request waiting
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+static void HostTwiStart(void)
+{
+  // ISR served own slave during transaction of winner
+  if (otherAddressed) {
+    HostTwiServe();
+  }
+  // other master meanwhile, repeated START keeps bus
+  if (!hostTwiPhase) {
+    HostTwiOther(hostTwiTime);
+  }
+  // bus busy - hardware waits for STOP
+  if (!hostTwiPhase && (otherEnd > hostTwiTime)) {
+    HostTwiDelay(otherEnd - hostTwiTime);
+    // requests during wait
+    while ((otherRate > 0) && (otherNext < hostTwiTime)) {
+      otherQueue++;
+      otherNext += HostTwiGap();
+    }
+    // other master starts at same time
+    if (otherQueue) {
+      otherQueue--;
+      hostTwiContend = 1;
+    }
+  }
+  HostTwiDelay(HostTwiBit());
+  hostTwiPhase = 1;
+  hostTwsr = (hostTwsr & 0x03) | TWI_START_ACK;
+}
+
+/**
+ * @desc    Byte - address with arbitration, data
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+static void HostTwiByte(void)
+{
+  uint8_t other = (uint8_t) ((0x08 + HostTwiRandom() % (0x78 - 0x08)) << 1);
+  uint8_t address = hostTwdr >> 1;
+  uint8_t own = 0;
+  uint8_t status;
+  int8_t bit;
+
+  // address
+  if (hostTwiPhase == 1) {
+    hostTwiPhase = 2;
+    // wired AND - first 1 against 0 loses
+    if (hostTwiContend) {
+      hostTwiContend = 0;
+      // own slave as target of other master
+      if ((own = HostTwiOwn()) != 0) {
+        other = own;
+      }
+      for (bit = 7; bit >= 0; bit--) {
+        if ((hostTwdr ^ other) & (1 << bit)) {
+          break;
+        }
+      }
+      // other master goes on, scanner off bus
+      if ((bit >= 0) && (hostTwdr & (1 << bit))) {
+        otherEnd = hostTwiTime - HostTwiBit() + otherLength;
+        HostTwiDelay((8 - bit) * HostTwiBit());
+        hostTwiFree = hostTwiTime;
+        hostTwiPhase = 0;
+        // own slave addressed - served by ISR before next START
+        if (own) {
+          otherAddressed = own;
+          hostTwsr = (hostTwsr & 0x03) | ((own & 1) ? TWI_ST_ALMOA_ACK : TWI_SR_ALMOA_ACK);
+        } else {
+          hostTwsr = (hostTwsr & 0x03) | TWI_FLAG_ARB_LOST;
+        }
+        return;
+      }
+      // other master lost - repeats after STOP
+      otherQueue++;
+    }
+    if (HostTwiAcks(address)) {
+      status = (hostTwdr & 1) ? TWI_MR_SLAR_ACK : TWI_MT_SLAW_ACK;
+    } else {
+      status = (hostTwdr & 1) ? TWI_MR_SLAR_NACK : TWI_MT_SLAW_NACK;
+    }
+  // data - written acknowledged, read 0xFF, switch control register
+  } else if (hostTwsr & 0x40) {
+    hostTwdr = hostTwiTarget ? hostTwiTarget->control : 0xFF;
+    status = (hostTwcr & (1 << TWEA)) ? TWI_MR_DATA_ACK : TWI_MR_DATA_NACK;
+  } else {
+    status = TWI_MT_DATA_ACK;
+    if (hostTwiTarget) {
+      hostTwiTarget->control = hostTwdr;
+    } else {
+      hostTwiWrites++;
+    }
+    // receiver - NOT ACK on 0
+    if (hostTwiRx) {
+      if (!hostTwiReceive(hostTwdr, hostTwiRx == 1)) {
+        status = TWI_MT_DATA_NACK;
+      }
+      hostTwiRx = 2;
+    }
+  }
+  HostTwiDelay(9 * HostTwiBit());
+  hostTwsr = (hostTwsr & 0x03) | status;
+}
+
+/**
+ * @desc    Operation written to control register - START, byte,
+ *          STOP - done on bus, status and TWINT set
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+void HostTwiRun(void)
+{
+  // STOP - TWINT not set
+  if (hostTwcr & (1 << TWSTO)) {
+    HostTwiDelay(HostTwiBit());
+    hostTwiPhase = 0;
+    hostTwiFree = hostTwiTime;
+    hostTwcr &= ~(1 << TWSTO);
+    return;
+  }
+  // START / repeated START
+  if (hostTwcr & (1 << TWSTA)) {
+    HostTwiStart();
+  } else {
+    HostTwiByte();
+  }
+  hostTwcr |= (1 << TWINT);
+}
@@ -0,0 +1,158 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Host model of TWI master - devices, switches, other master
+ * -------------------------------------------------------------+
+ *
+ * @file        hosttwi.h
+ * @tested      Linux, gcc
+ * -------------------------------------------------------------+
+ */
+
+#include <stdint.h>
+
+#ifndef __HOSTTWI_H__
+#define __HOSTTWI_H__
+
+  // clock of modelled part
+  #define _FCPU 16000000
+
+  // TWI and Timer1 registers
+  extern volatile uint8_t hostTwcr;
+  extern volatile uint8_t hostTwsr;
+  extern volatile uint8_t hostTwbr;
+  extern volatile uint8_t hostTwdr;
+  extern volatile uint8_t hostTwar;
+  extern volatile uint16_t hostTcnt1;
+  extern volatile uint8_t hostTimer;
+  #define TWI_TWCR hostTwcr
+  #define TWI_TWSR hostTwsr
+  #define TWI_TWBR hostTwbr
+  #define TWI_TWDR hostTwdr
+  #define TWI_TWAR hostTwar
+  #define TCNT1    hostTcnt1
+  #define TCCR1A   hostTimer
+  #define TCCR1B   hostTimer
+  #define CS11     1
+  #define TWINT    7
+  #define TWEA     6
+  #define TWSTA    5
+  #define TWSTO    4
+  #define TWEN     2
+  #define TWIE     0
+
+  // bus operation done by model instead of hardware
+  #define TWI_WAIT_TILL_TWINT_IS_SET() { HostTwiRun(); }
+  #define TWI_WAIT_TILL_TWSTO_IS_CLEARED() { HostTwiRun(); }
+  #define TWI_WAIT_MS() { HostTwiDelay(1000.0); }
+
+  // slave interrupt called by model - other master addressing own
+  // slave after winning arbitration (HostTwiSlave)
+  #define ISR(vector) void vector(void)
+  #define TWI_vect HostTwiVector
+  #define sei()
+
+  /** @var Time of model in us */
+  extern double hostTwiTime;
+  /** @var Data bytes written to devices other than switches */
+  extern uint32_t hostTwiWrites;
+  /** @var Transfers with own slave served by ISR */
+  extern uint32_t hostTwiServed;
+
+  /** @typedef Receiver of data bytes - byte, first byte after SLA+W;
+   *           returns 0 for NOT ACK */
+  typedef uint8_t (*THostTwiReceive)(uint8_t, uint8_t);
+
+  /**
+   * @desc    Device acknowledges address
+   *
+   * @param   uint8_t address
+   *
+   * @return  void
+   */
+  void HostTwiDevice(uint8_t);
+
+  /**
+   * @desc    Device with receiver of written bytes - display model,
+   *          acknowledges address, data acknowledged by receiver
+   *
+   * @param   uint8_t address
+   * @param   THostTwiReceive
+   *
+   * @return  void
+   */
+  void HostTwiReceiver(uint8_t, THostTwiReceive);
+
+  /**
+   * @desc    Switch (TCA9548A) - acknowledges address, control register
+   *          written by data byte, read back; channels off at start
+   *
+   * @param   uint8_t address
+   *
+   * @return  void
+   */
+  void HostTwiSwitch(uint8_t);
+
+  /**
+   * @desc    Device on channel of switch - acknowledges while channel
+   *          enabled
+   *
+   * @param   uint8_t switch address
+   * @param   uint8_t channel 0 - 7
+   * @param   uint8_t device address
+   *
+   * @return  void
+   */
+  void HostTwiBehind(uint8_t, uint8_t, uint8_t);
+
+  /**
+   * @desc    Other master - transactions at random times, each holding
+   *          bus for length; addresses of its transactions random
+   *          over 0x08 - 0x77
+   *
+   * @param   double transactions per second, 0 none
+   * @param   double length of transaction in us
+   * @param   uint32_t seed
+   *
+   * @return  void
+   */
+  void HostTwiMaster(double, double, uint32_t);
+
+  /**
+   * @desc    Other master addresses own slave (TWAR) in share of its
+   *          transactions
+   *
+   * @param   double share 0 - 1
+   *
+   * @return  void
+   */
+  void HostTwiSlave(double);
+
+  /**
+   * @desc    Operation written to control register - START, byte,
+   *          STOP - done on bus, status and TWINT set
+   *
+   * @param   void
+   *
+   * @return  void
+   */
+  void HostTwiRun(void);
+
+  /**
+   * @desc    Time passes - software, backoff
+   *
+   * @param   double us
+   *
+   * @return  void
+   */
+  void HostTwiDelay(double);
+
+  /**
+   * @desc    Slave interrupt handler - ISR(TWI_vect) of twi.c
+   *
+   * @param   void
+   *
+   * @return  void
+   */
+  void HostTwiVector(void);
+
+#endif
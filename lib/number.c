@@ -0,0 +1,127 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        Integer formatting and delta rendered numbers
+ * -------------------------------------------------------------+ 
+ *
+ * @file        number.c
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+// include libraries
+#if defined(__AVR__)
+  #include <avr/pgmspace.h>
+#else
+  #include "hostpgm.h"
+#endif
+#include "number.h"
+#include "display.h"
+
+/** @array Digits */
+static const char DIGITS[] PROGMEM = "0123456789abcdef";
+
+/**
+ * @desc    Format number right aligned, no allocation
+ *
+ * @param   char * string, width + 1 bytes at least
+ * @param   uint32_t value
+ * @param   uint8_t base 10 / 16
+ * @param   uint8_t width - min number of characters, 0 as needed
+ * @param   char padding - '0' / ' '
+ *
+ * @return  uint8_t length
+ */
+uint8_t NumberFormat(char *str, uint32_t value, uint8_t base, uint8_t width, char padding)
+{
+  char digits[NUMBER_DIGITS];
+  uint8_t count = 0;
+  uint8_t length = 0;
+
+  // digits from lowest, zero has one digit
+  do {
+    // hex by shift, decimal by division
+    if (base == 16) {
+      digits[count++] = pgm_read_byte(&DIGITS[value & 0x0F]);
+      value >>= 4;
+    } else {
+      digits[count++] = pgm_read_byte(&DIGITS[value % 10]);
+      value /= 10;
+    }
+  } while (value);
+  // padding
+  while (width > count) {
+    str[length++] = padding;
+    width--;
+  }
+  // digits from highest
+  while (count) {
+    str[length++] = digits[--count];
+  }
+  str[length] = '\0';
+  // length
+  return length;
+}
+
+/**
+ * @desc    Init number on screen - first draw paints all cells
+ *
+ * @param   TNumber *
+ * @param   uint8_t x
+ * @param   uint8_t y
+ * @param   uint8_t width in cells
+ * @param   uint8_t base 10 / 16
+ * @param   uint16_t color
+ * @param   uint16_t background
+ *
+ * @return  void
+ */
+void NumberInit(TNumber *number, uint8_t x, uint8_t y, uint8_t width, uint8_t base, uint16_t color, uint16_t background)
+{
+  uint8_t i;
+
+  number->x = x;
+  number->y = y;
+  number->width = (width > NUMBER_DIGITS) ? NUMBER_DIGITS : width;
+  number->base = base;
+  number->color = color;
+  number->background = background;
+  // nothing drawn
+  for (i = 0; i < NUMBER_DIGITS; i++) {
+    number->digits[i] = 0;
+  }
+}
+
+/**
+ * @desc    Draw number - only changed cells are repainted
+ *
+ * @param   TNumber *
+ * @param   uint32_t value
+ *
+ * @return  uint8_t number of repainted cells
+ */
+uint8_t NumberDraw(TNumber *number, uint32_t value)
+{
+  char str[NUMBER_DIGITS + 1];
+  uint8_t length;
+  uint8_t offset;
+  uint8_t painted = 0;
+  uint8_t i;
+
+  // right aligned in cells, spaces before
+  length = NumberFormat(str, value, number->base, number->width, ' ');
+  // lowest digits if too long
+  offset = length - number->width;
+  // changed cells only
+  for (i = 0; i < number->width; i++) {
+    if (number->digits[i] != str[offset + i]) {
+      // cell position
+      SetPosition(number->x + i * (CHARS_COLS_LEN + 1), number->y);
+      // cell with background
+      DrawCharOpaque(str[offset + i], number->color, number->background, X1);
+      number->digits[i] = str[offset + i];
+      painted++;
+    }
+  }
+  // cells repainted
+  return painted;
+}
@@ -0,0 +1,73 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        Integer formatting and delta rendered numbers
+ * -------------------------------------------------------------+ 
+ *
+ * @file        number.h
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+#include <stdint.h>
+
+#ifndef __NUMBER_H__
+#define __NUMBER_H__
+
+  // max digits of widget - 32 bits decimal
+  #define NUMBER_DIGITS 10
+
+  /** @struct Number on screen - digits last drawn */
+  typedef struct {
+    // position of first cell
+    uint8_t x;
+    uint8_t y;
+    // number of cells
+    uint8_t width;
+    // 10 or 16
+    uint8_t base;
+    // colors
+    uint16_t color;
+    uint16_t background;
+    // drawn characters, 0 - cell not drawn yet
+    char digits[NUMBER_DIGITS];
+  } TNumber;
+
+  /**
+   * @desc    Format number right aligned, no allocation
+   *
+   * @param   char * string, width + 1 bytes at least
+   * @param   uint32_t value
+   * @param   uint8_t base 10 / 16
+   * @param   uint8_t width - min number of characters, 0 as needed
+   * @param   char padding - '0' / ' '
+   *
+   * @return  uint8_t length
+   */
+  uint8_t NumberFormat(char *, uint32_t, uint8_t, uint8_t, char);
+
+  /**
+   * @desc    Init number on screen - first draw paints all cells
+   *
+   * @param   TNumber *
+   * @param   uint8_t x
+   * @param   uint8_t y
+   * @param   uint8_t width in cells
+   * @param   uint8_t base 10 / 16
+   * @param   uint16_t color
+   * @param   uint16_t background
+   *
+   * @return  void
+   */
+  void NumberInit(TNumber *, uint8_t, uint8_t, uint8_t, uint8_t, uint16_t, uint16_t);
+
+  /**
+   * @desc    Draw number - only changed cells are repainted
+   *
+   * @param   TNumber *
+   * @param   uint32_t value
+   *
+   * @return  uint8_t number of repainted cells
+   */
+  uint8_t NumberDraw(TNumber *, uint32_t);
+
+#endif
@@ -0,0 +1,108 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Hot path counters of drivers, compiled out by default
+ * -------------------------------------------------------------+
+ *
+ * @file        perf.c
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+
+ */
+
+// include libraries
+#include <string.h>
+#include "perf.h"
+
+#if defined(__AVR__)
+  #include <avr/pgmspace.h>
+  #include <util/atomic.h>
+#else
+  #include "hostpgm.h"
+#endif
+
+/** @def Name of counter in flash */
+#define PERF_NAME(field, name) static const char PERF_NAME_##field[] PROGMEM = name;
+/** @def Entry of name table */
+#define PERF_ENTRY(field, name) PERF_NAME_##field,
+
+// names
+PERF_LIST(PERF_NAME)
+
+/** @array Names of counters in flash */
+static const char * const PERF_NAMES[] PROGMEM = {
+  PERF_LIST(PERF_ENTRY)
+};
+
+#ifdef PERF_COUNTERS
+/** @var Counters */
+volatile TPerf perf;
+#endif
+
+/**
+ * @desc    Copy of counters taken with interrupts off
+ *
+ * @param   TPerf * snapshot, zeros if counters compiled out
+ *
+ * @return  void
+ */
+void PerfSnapshot(TPerf *snapshot)
+{
+#ifdef PERF_COUNTERS
+#if defined(__AVR__)
+  // SPI interrupt counts too
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    memcpy(snapshot, (const void *) &perf, sizeof(TPerf));
+  }
+#else
+  memcpy(snapshot, (const void *) &perf, sizeof(TPerf));
+#endif
+#else
+  // nothing counted
+  memset(snapshot, 0, sizeof(TPerf));
+#endif
+}
+
+/**
+ * @desc    Clear counters
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+void PerfReset(void)
+{
+#ifdef PERF_COUNTERS
+#if defined(__AVR__)
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    memset((void *) &perf, 0, sizeof(TPerf));
+  }
+#else
+  memset((void *) &perf, 0, sizeof(TPerf));
+#endif
+#endif
+}
+
+/**
+ * @desc    Counter of snapshot by index
+ *
+ * @param   const TPerf * snapshot
+ * @param   uint8_t index < PERF_SIZE
+ *
+ * @return  uint32_t
+ */
+uint32_t PerfGet(const TPerf *snapshot, uint8_t index)
+{
+  // fields are uint32_t in list order
+  return (index < PERF_SIZE) ? ((const uint32_t *) snapshot)[index] : 0;
+}
+
+/**
+ * @desc    Name of counter by index
+ *
+ * @param   uint8_t index < PERF_SIZE
+ *
+ * @return  const char * name in flash, NULL out of range
+ */
+const char *PerfName(uint8_t index)
+{
+  return (index < PERF_SIZE) ? (const char *) pgm_read_ptr(&PERF_NAMES[index]) : NULL;
+}
@@ -0,0 +1,99 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Hot path counters of drivers, compiled out by default
+ * -------------------------------------------------------------+
+ *
+ * @file        perf.h
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+
+ */
+
+#include <stdint.h>
+
+#ifndef __PERF_H__
+#define __PERF_H__
+
+  // PERF_COUNTERS - counters compiled in, without it PERF_INC / PERF_ADD
+  // expand to nothing and drivers keep their size and timing
+
+  /** @def Counters - C(field, name) */
+  #define PERF_LIST(C) \
+    C(twiStarts,  "start") /* TWI START conditions */ \
+    C(twiProbes,  "probe") /* TWI address probes */ \
+    C(twiAcks,    "ack")   /* TWI address / data acknowledged */ \
+    C(twiNacks,   "nack")  /* TWI address / data not acknowledged */ \
+    C(twiArbLost, "arb")   /* TWI arbitration lost */ \
+    C(twiWaits,   "wait")  /* TWI loop iterations waiting for TWINT */ \
+    C(spiBytes,   "spi")   /* SPI bytes to display */ \
+    C(spiSelects, "cs")    /* display chip select toggles */ \
+    C(windows,    "win")   /* SetWindow calls */ \
+    C(pixels,     "px")    /* pixels written */
+
+  /** @def Struct field */
+  #define PERF_FIELD(field, name) uint32_t field;
+  /** @def Count */
+  #define PERF_COUNT(field, name) + 1
+
+  // number of counters
+  #define PERF_SIZE (0 PERF_LIST(PERF_COUNT))
+
+  /** @struct Counters */
+  typedef struct {
+    PERF_LIST(PERF_FIELD)
+  } TPerf;
+
+  #ifdef PERF_COUNTERS
+
+    /** @var Counters */
+    extern volatile TPerf perf;
+
+    // increment counter
+    #define PERF_INC(field) (perf.field++)
+    // add to counter
+    #define PERF_ADD(field, n) (perf.field += (n))
+
+  #else
+
+    #define PERF_INC(field) ((void) 0)
+    #define PERF_ADD(field, n) ((void) 0)
+
+  #endif
+
+  /**
+   * @desc    Copy of counters taken with interrupts off
+   *
+   * @param   TPerf * snapshot, zeros if counters compiled out
+   *
+   * @return  void
+   */
+  void PerfSnapshot(TPerf *);
+
+  /**
+   * @desc    Clear counters
+   *
+   * @param   void
+   *
+   * @return  void
+   */
+  void PerfReset(void);
+
+  /**
+   * @desc    Counter of snapshot by index
+   *
+   * @param   const TPerf * snapshot
+   * @param   uint8_t index < PERF_SIZE
+   *
+   * @return  uint32_t
+   */
+  uint32_t PerfGet(const TPerf *, uint8_t);
+
+  /**
+   * @desc    Name of counter by index
+   *
+   * @param   uint8_t index < PERF_SIZE
+   *
+   * @return  const char * name in flash, NULL out of range
+   */
+  const char *PerfName(uint8_t);
+
+#endif
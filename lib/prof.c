@@ -0,0 +1,226 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Sampling profiler - Timer2, histogram of flash
+ * -------------------------------------------------------------+
+ *
+ * @file        prof.c
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+
+ */
+
+// include libraries
+#include <string.h>
+#include "prof.h"
+#include "number.h"
+
+#if defined(PROFILE) && defined(__AVR__)
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+// return address of 2 bytes and byte address of flash in 16 bits
+#if FLASHEND > 0xFFFF
+  #error "PROFILE supports up to 64 kB of flash"
+#endif
+
+/** @var Samples per bin */
+static volatile uint16_t profBins[PROFILE_BINS];
+/** @var All samples */
+static volatile uint32_t profSamples = 0;
+/** @var Samples out of window */
+static volatile uint32_t profOutside = 0;
+/** @var First byte address of window */
+static uint16_t profStart = PROFILE_START;
+/** @var Bin of 2^shift bytes */
+static uint8_t profShift = PROFILE_SHIFT;
+
+/**
+ * @desc    Sample to histogram, called by ISR with interrupts off
+ *
+ * @param   uint16_t word address of interrupted instruction
+ *
+ * @return  void
+ */
+void ProfSample(uint16_t) __attribute__((used));
+void ProfSample(uint16_t pc)
+{
+  // byte address in window, below start wraps out of window
+  uint16_t bin = (uint16_t) ((pc << 1) - profStart) >> profShift;
+
+  // all samples - full counter stops sampling, outside never more
+  if (++profSamples == 0xFFFFFFFF) {
+    TIMSK &= ~(1 << OCIE2);
+  }
+  // out of window
+  if (bin >= PROFILE_BINS) {
+    profOutside++;
+  // full bin stops sampling - shares stay correct
+  } else if (++profBins[bin] == 0xFFFF) {
+    TIMSK &= ~(1 << OCIE2);
+  }
+}
+
+/**
+ * @desc    Timer2 compare match - registers C may change saved by hand,
+ *          return address read above them and passed to ProfSample
+ *
+ * @param   TIMER2_COMP_vect
+ *
+ * @return  void
+ */
+ISR(TIMER2_COMP_vect, ISR_NAKED)
+{
+  __asm__ __volatile__ (
+    // SREG, r0, zero register r1
+    "push r0"             "\n\t"
+    "in   r0, __SREG__"   "\n\t"
+    "push r0"             "\n\t"
+    "push r1"             "\n\t"
+    "clr  r1"             "\n\t"
+    // call clobbered
+    "push r18"            "\n\t"
+    "push r19"            "\n\t"
+    "push r20"            "\n\t"
+    "push r21"            "\n\t"
+    "push r22"            "\n\t"
+    "push r23"            "\n\t"
+    "push r24"            "\n\t"
+    "push r25"            "\n\t"
+    "push r26"            "\n\t"
+    "push r27"            "\n\t"
+    "push r30"            "\n\t"
+    "push r31"            "\n\t"
+    // return address above 15 pushed bytes - high byte first
+    "in   r30, __SP_L__"  "\n\t"
+    "in   r31, __SP_H__"  "\n\t"
+    "ldd  r25, Z+16"      "\n\t"
+    "ldd  r24, Z+17"      "\n\t"
+    "%~call ProfSample"   "\n\t"
+    // restore
+    "pop  r31"            "\n\t"
+    "pop  r30"            "\n\t"
+    "pop  r27"            "\n\t"
+    "pop  r26"            "\n\t"
+    "pop  r25"            "\n\t"
+    "pop  r24"            "\n\t"
+    "pop  r23"            "\n\t"
+    "pop  r22"            "\n\t"
+    "pop  r21"            "\n\t"
+    "pop  r20"            "\n\t"
+    "pop  r19"            "\n\t"
+    "pop  r18"            "\n\t"
+    "pop  r1"             "\n\t"
+    "pop  r0"             "\n\t"
+    "out  __SREG__, r0"   "\n\t"
+    "pop  r0"             "\n\t"
+    "reti"                "\n\t"
+    ::
+  );
+}
+
+/**
+ * @desc    Init Timer2, sampling stopped
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+void ProfInit(void)
+{
+  // compare value
+  OCR2 = PROFILE_TOP;
+  // CTC mode, prescaler 128
+  TCCR2 = (1 << WGM21) | (1 << CS22) | (1 << CS20);
+}
+
+/**
+ * @desc    Clear histogram, sample window from start in bins of 2^shift bytes
+ *
+ * @param   uint16_t start byte address in flash
+ * @param   uint8_t shift
+ *
+ * @return  void
+ */
+void ProfStart(uint16_t start, uint8_t shift)
+{
+  // stop before clear
+  ProfStop();
+  memset((void *) profBins, 0, sizeof(profBins));
+  profSamples = 0;
+  profOutside = 0;
+  // window
+  profStart = start;
+  profShift = (shift > 15) ? 15 : shift;
+  // full period to first sample
+  TCNT2 = 0;
+  TIFR = (1 << OCF2);
+  // compare match interrupt
+  TIMSK |= (1 << OCIE2);
+}
+
+/**
+ * @desc    Stop sampling, histogram kept
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+void ProfStop(void)
+{
+  // no interrupt, no sample
+  TIMSK &= ~(1 << OCIE2);
+}
+
+/**
+ * @desc    Line of dump, stops sampling
+ *            0 - prof <start> <shift> <bins> <Hz> <samples> <outside>
+ *            bin - <address> <samples>, empty bins skipped
+ *            PROFILE_LINES - 1 - end
+ *
+ * @param   char * line PROFILE_LINE_SIZE
+ * @param   uint8_t index < PROFILE_LINES
+ *
+ * @return  uint8_t length, 0 nothing to send
+ */
+uint8_t ProfLine(char *line, uint8_t index)
+{
+  uint8_t i = 0;
+
+  // dump not disturbed by samples of itself
+  ProfStop();
+  // header
+  if (index == 0) {
+    strcpy(line, "prof ");
+    i = 5;
+    i += NumberFormat(line + i, profStart, 16, 4, '0');
+    line[i++] = ' ';
+    i += NumberFormat(line + i, profShift, 10, 0, ' ');
+    line[i++] = ' ';
+    i += NumberFormat(line + i, PROFILE_BINS, 10, 0, ' ');
+    line[i++] = ' ';
+    i += NumberFormat(line + i, PROFILE_HZ, 10, 0, ' ');
+    line[i++] = ' ';
+    i += NumberFormat(line + i, profSamples, 10, 0, ' ');
+    line[i++] = ' ';
+    i += NumberFormat(line + i, profOutside, 10, 0, ' ');
+  // bin
+  } else if (index < PROFILE_LINES - 1) {
+    // empty skipped
+    if (profBins[--index] == 0) {
+      return 0;
+    }
+    i += NumberFormat(line, profStart + ((uint16_t) index << profShift), 16, 4, '0');
+    line[i++] = ' ';
+    i += NumberFormat(line + i, profBins[index], 10, 0, ' ');
+  // end
+  } else {
+    strcpy(line, "end");
+    i = 3;
+  }
+  // line end
+  line[i++] = '\r';
+  line[i++] = '\n';
+  return i;
+}
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Sampling profiler - Timer2, histogram of flash
+ * -------------------------------------------------------------+
+ *
+ * @file        prof.h
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+
+ */
+
+#include <stdint.h>
+
+#ifndef __PROF_H__
+#define __PROF_H__
+
+  // PROFILE - profiler compiled in, without it Timer2 stays free
+  // and nothing of profiler is linked
+
+  #ifndef F_CPU
+    #define F_CPU 16000000
+  #endif
+
+  // Timer2 - CTC mode, prescaler 128, compare match every
+  //  128 * (PROFILE_TOP + 1) cycles - 992 Hz, not multiple of 1 ms
+  //  tick, so periodic work is not sampled at same point every time
+  #define PROFILE_PRESCALER 128
+  #ifndef PROFILE_TOP
+    #define PROFILE_TOP 125
+  #endif
+  #define PROFILE_HZ (F_CPU / PROFILE_PRESCALER / (PROFILE_TOP + 1))
+
+  // number of bins, 2 bytes each
+  #ifndef PROFILE_BINS
+    #define PROFILE_BINS 64
+  #endif
+  // default window - whole flash of Atmega16 in bins of 256 bytes,
+  //  narrowed at run time by prof on <start> <shift>
+  #ifndef PROFILE_START
+    #define PROFILE_START 0x0000
+  #endif
+  #ifndef PROFILE_SHIFT
+    #define PROFILE_SHIFT 8
+  #endif
+
+  // lines of dump - header, bins, end
+  #define PROFILE_LINES (PROFILE_BINS + 2)
+  // max length of dump line - header at worst 47 bytes with NUL:
+  //  "prof " FFFF, shift 2, bins 3, Hz 6 (20 MHz, top 0), samples and
+  //  outside 10 digits each, 5 spaces, CR LF
+  #define PROFILE_LINE_SIZE 48
+
+  /**
+   * @desc    Init Timer2, sampling stopped
+   *
+   * @param   void
+   *
+   * @return  void
+   */
+  void ProfInit(void);
+
+  /**
+   * @desc    Clear histogram, sample window from start in bins of 2^shift bytes
+   *
+   * @param   uint16_t start byte address in flash
+   * @param   uint8_t shift
+   *
+   * @return  void
+   */
+  void ProfStart(uint16_t, uint8_t);
+
+  /**
+   * @desc    Stop sampling, histogram kept
+   *
+   * @param   void
+   *
+   * @return  void
+   */
+  void ProfStop(void);
+
+  /**
+   * @desc    Line of dump, stops sampling
+   *            0 - prof <start> <shift> <bins> <Hz> <samples> <outside>
+   *            bin - <address> <samples>, empty bins skipped
+   *            PROFILE_LINES - 1 - end
+   *
+   * @param   char * line PROFILE_LINE_SIZE
+   * @param   uint8_t index < PROFILE_LINES
+   *
+   * @return  uint8_t length, 0 nothing to send
+   */
+  uint8_t ProfLine(char *, uint8_t);
+
+#endif
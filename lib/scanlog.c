@@ -0,0 +1,217 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        Scan records over serial - binary frames / text
+ * -------------------------------------------------------------+ 
+ *
+ * @file        scanlog.c
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+// include libraries
+#include <avr/pgmspace.h>
+#include "scanlog.h"
+#include "uart.h"
+#include "twi.h"
+
+/** @array Hex digits */
+static const char HEX[] PROGMEM = "0123456789abcdef";
+
+// hex digit from flash
+#define SCANLOG_HEX(digit) ((char) pgm_read_byte(&HEX[digit]))
+
+/**
+ * @desc    CRC-16/CCITT update - same as avr-libc _crc_ccitt_update
+ *
+ * @param   uint16_t crc
+ * @param   uint8_t data
+ *
+ * @return  uint16_t
+ */
+uint16_t ScanLogCrc(uint16_t crc, uint8_t data)
+{
+  // mix low byte of crc
+  data ^= (uint8_t) crc;
+  data ^= data << 4;
+  // new crc
+  return ((((uint16_t) data << 8) | (crc >> 8)) ^ (uint8_t) (data >> 4) ^ ((uint16_t) data << 3));
+}
+
+/**
+ * @desc    Append crc of length byte onward and send frame
+ *
+ * @param   uint8_t * frame with 2 bytes room for crc
+ * @param   uint8_t length without crc
+ *
+ * @return  char
+ */
+static char ScanLogSend(uint8_t *frame, uint8_t length)
+{
+  uint16_t crc = 0xFFFF;
+  uint8_t j;
+
+  // crc from length byte
+  for (j = 2; j < length; j++) {
+    crc = ScanLogCrc(crc, frame[j]);
+  }
+  frame[length++] = (uint8_t) crc;
+  frame[length++] = (uint8_t) (crc >> 8);
+  // whole frame or nothing
+  return UART_Write(frame, length);
+}
+
+/**
+ * @desc    Send scan as binary frame
+ *
+ * @param   uint16_t sequence number
+ * @param   uint32_t time in ms
+ * @param   const uint8_t * 16 bytes bitmap
+ * @param   uint16_t errors
+ *
+ * @return  char
+ */
+char ScanLogBinary(uint16_t seq, uint32_t time, const uint8_t *bitmap, uint16_t errors)
+{
+  uint8_t frame[SCANLOG_FRAME];
+  uint8_t i = 0;
+  uint8_t j;
+
+  // header
+  frame[i++] = SCANLOG_SYNC1;
+  frame[i++] = SCANLOG_SYNC2;
+  frame[i++] = SCANLOG_PAYLOAD;
+  // sequence number
+  frame[i++] = (uint8_t) seq;
+  frame[i++] = (uint8_t) (seq >> 8);
+  // time stamp
+  frame[i++] = (uint8_t) time;
+  frame[i++] = (uint8_t) (time >> 8);
+  frame[i++] = (uint8_t) (time >> 16);
+  frame[i++] = (uint8_t) (time >> 24);
+  // bitmap
+  for (j = 0; j < TWI_BITMAP_SIZE; j++) {
+    frame[i++] = bitmap[j];
+  }
+  // error counter
+  frame[i++] = (uint8_t) errors;
+  frame[i++] = (uint8_t) (errors >> 8);
+  // crc and send
+  return ScanLogSend(frame, i);
+}
+
+/**
+ * @desc    Send devices on channel of switch - channel frame or
+ *          text line "mux 70.3 <bitmap in hex>"
+ *
+ * @param   uint8_t switch address
+ * @param   uint8_t channel
+ * @param   const uint8_t * 16 bytes bitmap
+ * @param   uint8_t mode SCANLOG_BINARY / SCANLOG_TEXT
+ *
+ * @return  char
+ */
+char ScanLogChannel(uint8_t address, uint8_t channel, const uint8_t *bitmap, uint8_t mode)
+{
+  char line[9 + 2 * TWI_BITMAP_SIZE + 2];
+  uint8_t *frame = (uint8_t *) line;
+  uint8_t i = 0;
+  uint8_t j;
+
+  // binary frame
+  if (mode == SCANLOG_BINARY) {
+    frame[i++] = SCANLOG_SYNC1;
+    frame[i++] = SCANLOG_SYNC2;
+    frame[i++] = SCANLOG_CHANNEL_PAYLOAD;
+    frame[i++] = address;
+    frame[i++] = channel;
+    for (j = 0; j < TWI_BITMAP_SIZE; j++) {
+      frame[i++] = bitmap[j];
+    }
+    // crc and send
+    return ScanLogSend(frame, i);
+  }
+  // text line - switch.channel, bitmap bytes in hex
+  line[i++] = 'm';
+  line[i++] = 'u';
+  line[i++] = 'x';
+  line[i++] = ' ';
+  line[i++] = SCANLOG_HEX(address >> 4);
+  line[i++] = SCANLOG_HEX(address & 0x0F);
+  line[i++] = '.';
+  line[i++] = '0' + channel;
+  line[i++] = ' ';
+  for (j = 0; j < TWI_BITMAP_SIZE; j++) {
+    line[i++] = SCANLOG_HEX(bitmap[j] >> 4);
+    line[i++] = SCANLOG_HEX(bitmap[j] & 0x0F);
+  }
+  // end of line
+  line[i++] = '\r';
+  line[i++] = '\n';
+  // whole line or nothing
+  return UART_Write((const uint8_t *) line, i);
+}
+
+/**
+ * @desc    Send row of i2cdetect like table
+ *
+ *               0  1  2  3  4  5  6  7  8  9  a  b  c  d  e  f
+ *          00:                         -- -- -- -- -- -- -- --
+ *          10: -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --
+ *          ...
+ *          70: -- -- -- -- -- -- -- --
+ *
+ * @param   const uint8_t * 16 bytes bitmap
+ * @param   uint8_t row - 0 header, 1 .. 8 addresses
+ *
+ * @return  char
+ */
+char ScanLogTextRow(const uint8_t *bitmap, uint8_t row)
+{
+  char line[4 + 16 * 3 + 2];
+  uint8_t i = 0;
+  uint8_t col;
+  uint8_t address;
+
+  // header
+  if (row == 0) {
+    line[i++] = ' ';
+    line[i++] = ' ';
+    line[i++] = ' ';
+    for (col = 0; col < 16; col++) {
+      line[i++] = ' ';
+      line[i++] = ' ';
+      line[i++] = SCANLOG_HEX(col);
+    }
+  // addresses
+  } else {
+    line[i++] = SCANLOG_HEX(row - 1);
+    line[i++] = '0';
+    line[i++] = ':';
+    for (col = 0; col < 16; col++) {
+      address = ((row - 1) << 4) | col;
+      // row ends after last scanned
+      if (address > TWI_ADDR_LAST) {
+        break;
+      }
+      line[i++] = ' ';
+      // not scanned
+      if (address < TWI_ADDR_FIRST) {
+        line[i++] = ' ';
+        line[i++] = ' ';
+      // found
+      } else if (bitmap[address >> 3] & (1 << (address & 0x07))) {
+        line[i++] = SCANLOG_HEX(address >> 4);
+        line[i++] = SCANLOG_HEX(address & 0x0F);
+      // not found
+      } else {
+        line[i++] = '-';
+        line[i++] = '-';
+      }
+    }
+  }
+  // end of line
+  line[i++] = '\r';
+  line[i++] = '\n';
+  // whole row or nothing
+  return UART_Write((const uint8_t *) line, i);
+}
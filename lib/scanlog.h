@@ -0,0 +1,91 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        Scan records over serial - binary frames / text
+ * -------------------------------------------------------------+ 
+ *
+ * @file        scanlog.h
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+#include <stdint.h>
+
+#ifndef __SCANLOG_H__
+#define __SCANLOG_H__
+
+  // Binary frame, multi byte values little endian
+  //  +------+------+-----+-----+------+--------+--------+-------+
+  //  | 0xA5 | 0x5A | len | seq | time | bitmap | errors | crc   |
+  //  +------+------+-----+-----+------+--------+--------+-------+
+  //     1      1      1     2     4      16       2        2
+  //  len   - number of payload bytes (seq .. errors)
+  //  time  - ms from start
+  //  crc   - CRC-16/CCITT (reflected 0x8408, init 0xFFFF) of len .. errors
+  #define SCANLOG_SYNC1    0xA5
+  #define SCANLOG_SYNC2    0x5A
+  #define SCANLOG_PAYLOAD  24
+  #define SCANLOG_FRAME    (3 + SCANLOG_PAYLOAD + 2)
+
+  // Channel frame - devices on one channel of switch, sent during
+  // traversal before scan frame of same scan, told apart by len
+  //  +------+------+-----+--------+---------+--------+-------+
+  //  | 0xA5 | 0x5A | len | switch | channel | bitmap | crc   |
+  //  +------+------+-----+--------+---------+--------+-------+
+  //     1      1      1      1        1        16       2
+  #define SCANLOG_CHANNEL_PAYLOAD 18
+  #define SCANLOG_CHANNEL_FRAME   (3 + SCANLOG_CHANNEL_PAYLOAD + 2)
+
+  // text mode rows - header and 8 rows of 16 addresses
+  #define SCANLOG_ROWS     9
+
+  // output modes
+  #define SCANLOG_OFF      0
+  #define SCANLOG_BINARY   1
+  #define SCANLOG_TEXT     2
+
+  /**
+   * @desc    Send scan as binary frame
+   *
+   * @param   uint16_t sequence number
+   * @param   uint32_t time in ms
+   * @param   const uint8_t * 16 bytes bitmap
+   * @param   uint16_t errors
+   *
+   * @return  char
+   */
+  char ScanLogBinary(uint16_t, uint32_t, const uint8_t *, uint16_t);
+
+  /**
+   * @desc    Send row of i2cdetect like table
+   *
+   * @param   const uint8_t * 16 bytes bitmap
+   * @param   uint8_t row - 0 header, 1 .. 8 addresses
+   *
+   * @return  char
+   */
+  char ScanLogTextRow(const uint8_t *, uint8_t);
+
+  /**
+   * @desc    Send devices on channel of switch - channel frame or
+   *          text line "mux 70.3 <bitmap in hex>"
+   *
+   * @param   uint8_t switch address
+   * @param   uint8_t channel
+   * @param   const uint8_t * 16 bytes bitmap
+   * @param   uint8_t mode SCANLOG_BINARY / SCANLOG_TEXT
+   *
+   * @return  char
+   */
+  char ScanLogChannel(uint8_t, uint8_t, const uint8_t *, uint8_t);
+
+  /**
+   * @desc    CRC-16/CCITT update
+   *
+   * @param   uint16_t crc
+   * @param   uint8_t data
+   *
+   * @return  uint16_t
+   */
+  uint16_t ScanLogCrc(uint16_t, uint8_t);
+
+#endif
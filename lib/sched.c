@@ -0,0 +1,487 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        Cooperative scheduler / stackless tasks
+ * -------------------------------------------------------------+ 
+ *
+ * @file        sched.c
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+// include libraries
+#include "sched.h"
+
+#if defined(__AVR__)
+  #include <avr/io.h>
+  #include <avr/interrupt.h>
+  #include <avr/sleep.h>
+  #include <util/atomic.h>
+  #include <util/delay.h>
+#else
+  #include <time.h>
+#endif
+
+/** @var Tasks */
+static TTask *tasks[SCHED_MAX_TASKS];
+/** @var Number of tasks */
+static uint8_t tasksCount = 0;
+/** @var Timer counts spent outside tasks */
+static uint32_t idleTime = 0;
+/** @var Timer counts spent sleeping */
+static uint32_t sleepTime = 0;
+
+#if defined(__AVR__)
+
+/** @var Ticks (ms) */
+static volatile uint32_t ticks = 0;
+/** @var Tick timer running */
+static uint8_t timerOn = 0;
+
+/**
+ * @desc    Timer0 compare match - 1 ms tick
+ *
+ * @param   TIMER0_COMP_vect
+ *
+ * @return  void
+ */
+ISR(TIMER0_COMP_vect)
+{
+  // next tick
+  ticks++;
+}
+
+/**
+ * @desc    Init tick timer
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+static void SchedTimerInit(void)
+{
+  // compare value
+  OCR0 = SCHED_TIMER_TOP - 1;
+  // CTC mode, prescaler 64
+  TCCR0 = (1 << WGM01) | (1 << CS01) | (1 << CS00);
+  // compare match interrupt
+  TIMSK |= (1 << OCIE0);
+  // running
+  timerOn = 1;
+  // enable interrupts
+  sei();
+}
+
+/**
+ * @desc    Sleep till next interrupt - tick at latest
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+static void SchedSleepCpu(void)
+{
+  // clocks of timers and peripherals keep running
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  // sei before sleep takes effect after sleep - no interrupt lost
+  cli();
+  sleep_enable();
+  sei();
+  sleep_cpu();
+  sleep_disable();
+}
+
+/**
+ * @desc    Blocking delay, core sleeps between ticks
+ *
+ * @param   uint16_t ms
+ *
+ * @return  void
+ */
+void SchedDelay(uint16_t ms)
+{
+  uint16_t wake;
+
+  // before init - busy wait
+  if (!timerOn) {
+    while (ms--) {
+      _delay_ms(1);
+    }
+    return;
+  }
+  // tick to wake up, one more for partial tick
+  wake = SchedTicks() + ms + 1;
+  // sleep till tick reached
+  while (!SchedExpired(wake)) {
+    SchedSleepCpu();
+  }
+}
+
+/**
+ * @desc    Time stamp in timer counts
+ *
+ * @param   void
+ *
+ * @return  uint32_t
+ */
+uint32_t SchedStamp(void)
+{
+  uint32_t t;
+  uint8_t count;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    // read counter and ticks together
+    count = TCNT0;
+    t = ticks;
+    // compare match pending - tick not counted yet
+    if ((TIFR & (1 << OCF0)) && (count < (SCHED_TIMER_TOP >> 1))) {
+      t++;
+    }
+  }
+  // ticks and counts
+  return t * SCHED_TIMER_TOP + count;
+}
+
+/**
+ * @desc    Ticks (ms) from init
+ *
+ * @param   void
+ *
+ * @return  uint16_t
+ */
+uint16_t SchedTicks(void)
+{
+  uint16_t t;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    // read ticks
+    t = (uint16_t) ticks;
+  }
+  // ticks
+  return t;
+}
+
+/**
+ * @desc    Milliseconds from init - 32 bits tick counter, wraps
+ *          after ~49.7 days
+ *
+ * @param   void
+ *
+ * @return  uint32_t
+ */
+uint32_t SchedMillis(void)
+{
+  uint32_t t;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    // read ticks
+    t = ticks;
+  }
+  // ticks
+  return t;
+}
+
+#else
+
+/** @var Host start time */
+static struct timespec start;
+
+/**
+ * @desc    Init host clock
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+static void SchedTimerInit(void)
+{
+  // start time
+  clock_gettime(CLOCK_MONOTONIC, &start);
+}
+
+/**
+ * @desc    Elapsed host time from init - monotonic, no wrap
+ *
+ * @param   void
+ *
+ * @return  uint64_t ns
+ */
+static uint64_t SchedElapsed(void)
+{
+  struct timespec now;
+
+  // elapsed time
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) (now.tv_sec - start.tv_sec) * 1000000000ULL + now.tv_nsec - start.tv_nsec;
+}
+
+/**
+ * @desc    Time stamp in timer counts - same units as on AVR
+ *
+ * @param   void
+ *
+ * @return  uint32_t
+ */
+uint32_t SchedStamp(void)
+{
+  // nanoseconds to timer counts
+  return (uint32_t) (SchedElapsed() / (1000000000ULL / (F_CPU / SCHED_PRESCALER)));
+}
+
+/**
+ * @desc    Ticks (ms) from init - from elapsed time, not from
+ *          stamp, which wraps at other count than 16 bits ticks
+ *
+ * @param   void
+ *
+ * @return  uint16_t
+ */
+uint16_t SchedTicks(void)
+{
+  // nanoseconds to ms
+  return (uint16_t) (SchedElapsed() / 1000000ULL);
+}
+
+/**
+ * @desc    Milliseconds from init - 32 bits tick counter, wraps
+ *          after ~49.7 days
+ *
+ * @param   void
+ *
+ * @return  uint32_t
+ */
+uint32_t SchedMillis(void)
+{
+  // nanoseconds to ms
+  return (uint32_t) (SchedElapsed() / 1000000ULL);
+}
+
+/**
+ * @desc    Sleep till next interrupt - host yields processor
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+static void SchedSleepCpu(void)
+{
+  struct timespec pause = { 0, 100000 };
+
+  // sleep 100 us
+  nanosleep(&pause, NULL);
+}
+
+/**
+ * @desc    Blocking delay
+ *
+ * @param   uint16_t ms
+ *
+ * @return  void
+ */
+void SchedDelay(uint16_t ms)
+{
+  uint16_t wake = SchedTicks() + ms + 1;
+
+  // sleep till tick reached
+  while (!SchedExpired(wake)) {
+    SchedSleepCpu();
+  }
+}
+
+#endif
+
+/**
+ * @desc    Init scheduler and tick timer
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+void SchedInit(void)
+{
+  // no tasks
+  tasksCount = 0;
+  // tick timer
+  SchedTimerInit();
+}
+
+/**
+ * @desc    Add task
+ *
+ * @param   TTask *
+ * @param   task function
+ * @param   const char * name in flash
+ *
+ * @return  char
+ */
+char SchedAdd(TTask *task, char (*func)(TTask *), const char *name)
+{
+  // check if full
+  if (tasksCount >= SCHED_MAX_TASKS) {
+    // error
+    return 1;
+  }
+  // init task
+  task->func = func;
+  task->name = name;
+  task->lc = 0;
+  task->wake = 0;
+  task->runtime = 0;
+  task->runs = 0;
+  // store task
+  tasks[tasksCount++] = task;
+  // success
+  return 0;
+}
+
+/**
+ * @desc    Check if tick is reached
+ *
+ * @param   uint16_t tick
+ *
+ * @return  char
+ */
+char SchedExpired(uint16_t tick)
+{
+  // wrap safe difference
+  return (int16_t) (SchedTicks() - tick) >= 0;
+}
+
+/**
+ * @desc    Run every task once
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+void SchedRunOnce(void)
+{
+  uint8_t i = 0;
+  uint8_t j;
+  uint8_t ready = 0;
+  uint32_t begin;
+  uint32_t end;
+  uint32_t loop = SchedStamp();
+  uint32_t busy = 0;
+  TTask *task;
+
+  // loop through tasks
+  while (i < tasksCount) {
+    // task
+    task = tasks[i];
+    // run and account
+    begin = SchedStamp();
+    j = task->func(task);
+    end = SchedStamp();
+    task->runtime += end - begin;
+    task->runs++;
+    busy += end - begin;
+    // check if task has work left
+    if (j == TASK_READY) {
+      ready = 1;
+    }
+    // check if task ended
+    if (j == TASK_ENDED) {
+      // remove task
+      for (j = i + 1; j < tasksCount; j++) {
+        tasks[j - 1] = tasks[j];
+      }
+      tasksCount--;
+    } else {
+      // next task
+      i++;
+    }
+  }
+  // loop time outside tasks
+  idleTime += (SchedStamp() - loop) - busy;
+  // every task waits for time or interrupt - sleep till next interrupt,
+  // flag set by interrupt just before sleep waits for next tick (1 ms)
+  if (!ready) {
+    begin = SchedStamp();
+    SchedSleepCpu();
+    sleepTime += SchedStamp() - begin;
+  }
+}
+
+/**
+ * @desc    Run tasks forever
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+void SchedRun(void)
+{
+  // forever
+  while (1) {
+    // one round
+    SchedRunOnce();
+  }
+}
+
+/**
+ * @desc    Timer counts of scheduler loop spent outside tasks
+ *
+ * @param   void
+ *
+ * @return  uint32_t
+ */
+uint32_t SchedIdle(void)
+{
+  // idle time
+  return idleTime;
+}
+
+/**
+ * @desc    Timer counts spent sleeping - no task ready
+ *
+ * @param   void
+ *
+ * @return  uint32_t
+ */
+uint32_t SchedSleep(void)
+{
+  // sleep time
+  return sleepTime;
+}
+
+/**
+ * @desc    Timer counts measured - every task, loop outside tasks
+ *          and sleep
+ *
+ * @param   void
+ *
+ * @return  uint32_t
+ */
+uint32_t SchedRuntime(void)
+{
+  uint32_t total = idleTime + sleepTime;
+  uint8_t i;
+
+  // loop through tasks
+  for (i = 0; i < tasksCount; i++) {
+    total += tasks[i]->runtime;
+  }
+  // measured time
+  return total;
+}
+
+/**
+ * @desc    Reset runtime accounting
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+void SchedResetStats(void)
+{
+  uint8_t i;
+
+  // loop through tasks
+  for (i = 0; i < tasksCount; i++) {
+    tasks[i]->runtime = 0;
+    tasks[i]->runs = 0;
+  }
+  // idle
+  idleTime = 0;
+  sleepTime = 0;
+}
@@ -0,0 +1,191 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        Cooperative scheduler / stackless tasks
+ * -------------------------------------------------------------+ 
+ *
+ * @file        sched.h
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+#include <stdint.h>
+
+#ifndef __SCHED_H__
+#define __SCHED_H__
+
+  #ifndef F_CPU
+    #define F_CPU 16000000
+  #endif
+
+  // max number of tasks
+  #ifndef SCHED_MAX_TASKS
+    #define SCHED_MAX_TASKS 6
+  #endif
+
+  // longest delay - 16 bit wake tick compared as signed difference
+  #define SCHED_DELAY_MAX 0x7FFF
+
+  // Timer0 - CTC mode, prescaler 64, compare match every 1 ms
+  #define SCHED_PRESCALER 64
+  #define SCHED_TIMER_TOP (F_CPU / SCHED_PRESCALER / 1000)
+
+  // task return values
+  //  waiting - blocked on condition, ready - yielded with work left
+  #define TASK_WAITING 0
+  #define TASK_ENDED   1
+  #define TASK_READY   2
+
+  /** @struct Task - local continuation and accounting */
+  typedef struct TTask {
+    // task function
+    char (*func)(struct TTask *);
+    // task name, string in flash (PSTR) - pointer only
+    const char *name;
+    // local continuation - line to resume
+    uint16_t lc;
+    // tick to wake up
+    uint16_t wake;
+    // runtime in timer counts (SCHED_PRESCALER cycles)
+    uint32_t runtime;
+    // number of runs
+    uint16_t runs;
+  } TTask;
+
+  // Task body begin - resume at stored line
+  //  locals do not survive yields, keep state in static variables
+  #define TASK_BEGIN(t)         switch ((t)->lc) { case 0:
+
+  // Task body end - task ends and is removed
+  #define TASK_END(t)           } (t)->lc = 0; return TASK_ENDED;
+
+  // Yield to other tasks
+  #define TASK_YIELD(t)         do { (t)->lc = __LINE__; return TASK_READY; case __LINE__:; } while (0)
+
+  // Wait till condition is true
+  #define TASK_WAIT_UNTIL(t, c) do { (t)->lc = __LINE__; case __LINE__: if (!(c)) { return TASK_WAITING; } } while (0)
+
+  // Wait number of ticks (ms)
+  #define TASK_DELAY(t, ms)     do { (t)->wake = SchedTicks() + (ms); TASK_WAIT_UNTIL(t, SchedExpired((t)->wake)); } while (0)
+
+  /**
+   * @desc    Init scheduler and tick timer
+   *
+   * @param   void
+   *
+   * @return  void
+   */
+  void SchedInit(void);
+
+  /**
+   * @desc    Add task
+   *
+   * @param   TTask *
+   * @param   task function
+   * @param   const char * name in flash
+   *
+   * @return  char
+   */
+  char SchedAdd(TTask *, char (*)(TTask *), const char *);
+
+  /**
+   * @desc    Run every task once
+   *
+   * @param   void
+   *
+   * @return  void
+   */
+  void SchedRunOnce(void);
+
+  /**
+   * @desc    Run tasks forever
+   *
+   * @param   void
+   *
+   * @return  void
+   */
+  void SchedRun(void);
+
+  /**
+   * @desc    Ticks (ms) from init
+   *
+   * @param   void
+   *
+   * @return  uint16_t
+   */
+  uint16_t SchedTicks(void);
+
+  /**
+   * @desc    Milliseconds from init - 32 bits tick counter, wraps
+   *          after ~49.7 days
+   *
+   * @param   void
+   *
+   * @return  uint32_t
+   */
+  uint32_t SchedMillis(void);
+
+  /**
+   * @desc    Check if tick is reached
+   *
+   * @param   uint16_t tick
+   *
+   * @return  char
+   */
+  char SchedExpired(uint16_t);
+
+  /**
+   * @desc    Time stamp in timer counts (SCHED_PRESCALER cycles)
+   *
+   * @param   void
+   *
+   * @return  uint32_t
+   */
+  uint32_t SchedStamp(void);
+
+  /**
+   * @desc    Timer counts of scheduler loop spent outside tasks
+   *
+   * @param   void
+   *
+   * @return  uint32_t
+   */
+  uint32_t SchedIdle(void);
+
+  /**
+   * @desc    Timer counts spent sleeping - no task ready
+   *
+   * @param   void
+   *
+   * @return  uint32_t
+   */
+  uint32_t SchedSleep(void);
+
+  /**
+   * @desc    Timer counts measured - every task, loop outside tasks
+   *          and sleep
+   *
+   * @param   void
+   *
+   * @return  uint32_t
+   */
+  uint32_t SchedRuntime(void);
+
+  /**
+   * @desc    Blocking delay, core sleeps between ticks
+   *
+   * @param   uint16_t ms
+   *
+   * @return  void
+   */
+  void SchedDelay(uint16_t);
+
+  /**
+   * @desc    Reset runtime accounting
+   *
+   * @param   void
+   *
+   * @return  void
+   */
+  void SchedResetStats(void);
+
+#endif
@@ -0,0 +1,523 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        SSD1306 OLED driver - page framebuffer over TWI
+ * -------------------------------------------------------------+
+ *
+ * @file        ssd1306.c
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+
+ */
+
+// include libraries
+#include <string.h>
+#if defined(__AVR__)
+  #include <avr/pgmspace.h>
+#else
+  #include "hostpgm.h"
+#endif
+#include "ssd1306.h"
+#include "font.h"
+#include "twi.h"
+
+/** @array Init commands - horizontal addressing, charge pump on */
+static const uint8_t INIT_SSD1306[] PROGMEM = {
+  SSD1306_DISPLAY_OFF,
+  SSD1306_CLOCK_DIV, 0x80,
+  SSD1306_MULTIPLEX, SSD1306_HEIGHT - 1,
+  SSD1306_DISPLAY_OFFSET, 0x00,
+  SSD1306_START_LINE,
+  SSD1306_CHARGE_PUMP, 0x14,
+  SSD1306_MEMORY_MODE, 0x00,
+  SSD1306_SEG_REMAP,
+  SSD1306_COM_SCAN_DEC,
+  SSD1306_COM_PINS, (SSD1306_HEIGHT == 64) ? 0x12 : 0x02,
+  SSD1306_CONTRAST, 0xCF,
+  SSD1306_PRECHARGE, 0xF1,
+  SSD1306_VCOM_DETECT, 0x40,
+  SSD1306_DISPLAY_RAM,
+  SSD1306_NORMAL,
+  SSD1306_DISPLAY_ON
+};
+
+/** @def Glyph columns */
+#define GLYPH_COLS(c0, c1, c2, c3, c4) { c0, c1, c2, c3, c4 },
+
+/** @array Charset - column bytes, bit 0 top row as page bytes */
+static const uint8_t CHARACTERS[][CHARS_COLS_LEN] PROGMEM = {
+  FONT_5X8(GLYPH_COLS)
+};
+
+/** @var Framebuffer - page bytes, bit 0 top row of page */
+static uint8_t ssd1306Buffer[SSD1306_PAGES][SSD1306_WIDTH];
+/** @var Dirty columns of page, first > last clean */
+static uint8_t ssd1306First[SSD1306_PAGES];
+static uint8_t ssd1306Last[SSD1306_PAGES];
+
+/** @var Bytes sent by last flush */
+uint16_t ssd1306Bytes = 0;
+
+/** @var Text position row */
+static uint8_t cacheMemIndexRow = 0;
+/** @var Text position column */
+static uint8_t cacheMemIndexCol = 0;
+
+/**
+ * @desc    Mark columns of page dirty
+ *
+ * @param   uint8_t page
+ * @param   uint8_t first column
+ * @param   uint8_t last column
+ *
+ * @return  void
+ */
+static void Ssd1306Dirty(uint8_t page, uint8_t first, uint8_t last)
+{
+  // extend range
+  if (first < ssd1306First[page]) {
+    ssd1306First[page] = first;
+  }
+  if (last > ssd1306Last[page]) {
+    ssd1306Last[page] = last;
+  }
+}
+
+/**
+ * @desc    Init display - commands sent, framebuffer cleared
+ *
+ * @param   void
+ *
+ * @return  uint8_t
+ */
+uint8_t Ssd1306Init(void)
+{
+  uint8_t i;
+
+  // commands one by one from flash
+  for (i = 0; i < sizeof(INIT_SSD1306); i++) {
+    if (TWI_MT_WriteReg(SSD1306_ADDRESS, SSD1306_COMMAND, pgm_read_byte(&INIT_SSD1306[i])) != SUCCESS) {
+      return SSD1306_ERROR;
+    }
+  }
+  // black, whole screen dirty
+  ClearScreen(BLACK);
+  // success
+  return SSD1306_SUCCESS;
+}
+
+/**
+ * @desc    Flush dirty columns of pages - address window command and
+ *          one data write per page, 400 kHz bus gives about 40 full
+ *          frames per second on 128x64
+ *
+ * @param   void
+ *
+ * @return  uint8_t
+ */
+uint8_t Ssd1306Flush(void)
+{
+  uint8_t window[6];
+  uint8_t page;
+  uint8_t length;
+
+  // bytes of this flush
+  ssd1306Bytes = 0;
+  // loop through pages
+  for (page = 0; page < SSD1306_PAGES; page++) {
+    // clean page
+    if (ssd1306First[page] > ssd1306Last[page]) {
+      continue;
+    }
+    // dirty columns
+    length = ssd1306Last[page] - ssd1306First[page] + 1;
+    // column and page window
+    window[0] = SSD1306_COLUMN_ADDR;
+    window[1] = ssd1306First[page];
+    window[2] = ssd1306Last[page];
+    window[3] = SSD1306_PAGE_ADDR;
+    window[4] = page;
+    window[5] = page;
+    // window, then columns in one data stream
+    if ((TWI_MT_WriteRegs(SSD1306_ADDRESS, SSD1306_COMMAND, window, sizeof(window)) != SUCCESS) ||
+        (TWI_MT_WriteRegs(SSD1306_ADDRESS, SSD1306_DATA, &ssd1306Buffer[page][ssd1306First[page]], length) != SUCCESS)) {
+      // page stays dirty
+      return SSD1306_ERROR;
+    }
+    // SLA+W and control bytes of both writes
+    ssd1306Bytes += 2 + sizeof(window) + 2 + length;
+    // clean
+    ssd1306First[page] = 0xFF;
+    ssd1306Last[page] = 0;
+  }
+  // success
+  return SSD1306_SUCCESS;
+}
+
+/**
+ * @desc    Set text position
+ *
+ * @param   uint8_t x
+ * @param   uint8_t y
+ *
+ * @return  char
+ */
+char SetPosition(uint8_t x, uint8_t y)
+{
+  // check if coordinates is out of range
+  if ((x > MAX_X) || (y > MAX_Y)) {
+    // error
+    return SSD1306_ERROR;
+  }
+  // set position y
+  cacheMemIndexRow = y;
+  // set position x
+  cacheMemIndexCol = x;
+  // success
+  return SSD1306_SUCCESS;
+}
+
+/**
+ * @desc    Check text position, wrap to next line
+ *
+ * @param   uint8_t x
+ * @param   uint8_t y
+ * @param   ESizes
+ *
+ * @return  char
+ */
+char CheckPosition(uint8_t x, uint8_t y, ESizes size)
+{
+  // check if coordinates is out of range
+  if ((x > MAX_X) && (y > MAX_Y)) {
+    // out of range
+    return SSD1306_ERROR;
+  }
+  // next line
+  if ((x > MAX_X) && (y <= MAX_Y)) {
+    // set position y
+    cacheMemIndexRow = cacheMemIndexRow + (CHARS_ROWS_LEN + 1) * (size >> 4) + 2;
+    // set position x
+    cacheMemIndexCol = 2;
+  }
+  // success
+  return SSD1306_SUCCESS;
+}
+
+/**
+ * @desc    Draw pixel
+ *
+ * @param   uint8_t x
+ * @param   uint8_t y
+ * @param   uint16_t color
+ *
+ * @return  void
+ */
+void DrawPixel(uint8_t x, uint8_t y, uint16_t color)
+{
+  // out of screen
+  if ((x >= MAX_X) || (y >= MAX_Y)) {
+    return;
+  }
+  // set or clear bit
+  if (color != BLACK) {
+    ssd1306Buffer[y >> 3][x] |= 1 << (y & 0x07);
+  } else {
+    ssd1306Buffer[y >> 3][x] &= ~(1 << (y & 0x07));
+  }
+  // dirty column
+  Ssd1306Dirty(y >> 3, x, x);
+}
+
+/**
+ * @desc    Draw filled rectangle - masked page bytes
+ *
+ * @param   uint8_t x start
+ * @param   uint8_t x end
+ * @param   uint8_t y start
+ * @param   uint8_t y end
+ * @param   uint16_t color
+ *
+ * @return  void
+ */
+void DrawRectangle(uint8_t xs, uint8_t xe, uint8_t ys, uint8_t ye, uint16_t color)
+{
+  uint8_t temp;
+  uint8_t page, mask, x;
+
+  // check if start is > as end
+  if (xs > xe) {
+    temp = xe;
+    xe = xs;
+    xs = temp;
+  }
+  // check if start is > as end
+  if (ys > ye) {
+    temp = ye;
+    ye = ys;
+    ys = temp;
+  }
+  // out of screen
+  if ((xs >= MAX_X) || (ys >= MAX_Y)) {
+    return;
+  }
+  // clip
+  if (xe >= MAX_X) {
+    xe = MAX_X - 1;
+  }
+  if (ye >= MAX_Y) {
+    ye = MAX_Y - 1;
+  }
+  // loop through pages
+  for (page = ys >> 3; page <= (ye >> 3); page++) {
+    // rows of page inside rectangle
+    mask = 0xFF;
+    if (page == (ys >> 3)) {
+      mask &= 0xFF << (ys & 0x07);
+    }
+    if (page == (ye >> 3)) {
+      mask &= 0xFF >> (7 - (ye & 0x07));
+    }
+    // columns
+    for (x = xs; x <= xe; x++) {
+      if (color != BLACK) {
+        ssd1306Buffer[page][x] |= mask;
+      } else {
+        ssd1306Buffer[page][x] &= ~mask;
+      }
+    }
+    // dirty columns
+    Ssd1306Dirty(page, xs, xe);
+  }
+}
+
+/**
+ * @desc    Draw horizontal line
+ *
+ * @param   uint8_t x start
+ * @param   uint8_t x end
+ * @param   uint8_t y
+ * @param   uint16_t color
+ *
+ * @return  void
+ */
+void DrawLineHorizontal(uint8_t xs, uint8_t xe, uint8_t y, uint16_t color)
+{
+  // one row rectangle
+  DrawRectangle(xs, xe, y, y, color);
+}
+
+/**
+ * @desc    Draw vertical line
+ *
+ * @param   uint8_t x
+ * @param   uint8_t y start
+ * @param   uint8_t y end
+ * @param   uint16_t color
+ *
+ * @return  void
+ */
+void DrawLineVertical(uint8_t x, uint8_t ys, uint8_t ye, uint16_t color)
+{
+  // one column rectangle
+  DrawRectangle(x, x, ys, ye, color);
+}
+
+/**
+ * @desc    Draw line by Bresenham algoritm
+ *
+ * @param   uint8_t x start
+ * @param   uint8_t x end
+ * @param   uint8_t y start
+ * @param   uint8_t y end
+ * @param   uint16_t color
+ *
+ * @return  char
+ */
+char DrawLine(uint8_t x1, uint8_t x2, uint8_t y1, uint8_t y2, uint16_t color)
+{
+  int16_t dx = (x2 > x1) ? x2 - x1 : x1 - x2;
+  int16_t dy = (y2 > y1) ? y1 - y2 : y2 - y1;
+  int8_t sx = (x2 > x1) ? 1 : -1;
+  int8_t sy = (y2 > y1) ? 1 : -1;
+  int16_t error = dx + dy;
+
+  // till end point
+  while (1) {
+    // pixel
+    DrawPixel(x1, y1, color);
+    // end
+    if ((x1 == x2) && (y1 == y2)) {
+      break;
+    }
+    // step x
+    if ((error << 1) >= dy) {
+      error += dy;
+      x1 += sx;
+    }
+    // step y
+    if ((error << 1) <= dx) {
+      error += dx;
+      y1 += sy;
+    }
+  }
+  // success return
+  return 1;
+}
+
+/**
+ * @desc    Draw character - X1 on page boundary copies column bytes
+ *
+ * @param   char character
+ * @param   uint16_t color
+ * @param   ESizes
+ *
+ * @return  char
+ */
+char DrawChar(char character, uint16_t color, ESizes size)
+{
+  uint8_t wide = size & 0x0F;
+  uint8_t high = size >> 4;
+  uint8_t letter, col, row;
+
+  // check if character is out of range
+  if (((unsigned char) character < 0x20) || ((unsigned char) character > 0x7F)) {
+    return SSD1306_ERROR;
+  }
+  // loop through columns
+  for (col = 0; col < CHARS_COLS_LEN; col++) {
+    // read from ROM memory
+    letter = pgm_read_byte(&CHARACTERS[character - 32][col]);
+    // normal size aligned to page - column byte is page byte
+    if ((size == X1) && !(cacheMemIndexRow & 0x07) && (cacheMemIndexCol + col < MAX_X) && (cacheMemIndexRow < MAX_Y)) {
+      // set bits of font
+      if (color != BLACK) {
+        ssd1306Buffer[cacheMemIndexRow >> 3][cacheMemIndexCol + col] |= letter;
+      } else {
+        ssd1306Buffer[cacheMemIndexRow >> 3][cacheMemIndexCol + col] &= ~letter;
+      }
+      continue;
+    }
+    // loop through 8 bits
+    for (row = 0; row < CHARS_ROWS_LEN; row++) {
+      // check if bit set
+      if (letter & (1 << row)) {
+        // scaled pixel
+        DrawRectangle(cacheMemIndexCol + col * wide, cacheMemIndexCol + col * wide + wide - 1,
+                      cacheMemIndexRow + row * high, cacheMemIndexRow + row * high + high - 1, color);
+      }
+    }
+  }
+  // dirty columns of aligned character
+  if ((size == X1) && !(cacheMemIndexRow & 0x07) && (cacheMemIndexCol < MAX_X) && (cacheMemIndexRow < MAX_Y)) {
+    Ssd1306Dirty(cacheMemIndexRow >> 3, cacheMemIndexCol,
+                 (cacheMemIndexCol + CHARS_COLS_LEN - 1 < MAX_X) ? cacheMemIndexCol + CHARS_COLS_LEN - 1 : MAX_X - 1);
+  }
+  // success
+  return SSD1306_SUCCESS;
+}
+
+/**
+ * @desc    Draw string
+ *
+ * @param   const char * string
+ * @param   uint16_t color
+ * @param   ESizes
+ *
+ * @return  void
+ */
+void DrawString(volatile const char *str, uint16_t color, ESizes size)
+{
+  // width of cell
+  uint8_t cell = (CHARS_COLS_LEN + 1) * (size & 0x0F);
+
+  // loop through character of string
+  while (*str != '\0') {
+    // control if will be in range
+    if (SSD1306_SUCCESS != CheckPosition(cacheMemIndexCol + cell, cacheMemIndexRow, size)) {
+      return;
+    }
+    // read characters and increment index
+    DrawChar(*str++, color, size);
+    // update position
+    cacheMemIndexCol += cell;
+  }
+}
+
+/**
+ * @desc    Draw character with background - cell cleared, then drawn
+ *
+ * @param   char character
+ * @param   uint16_t color
+ * @param   uint16_t background
+ * @param   ESizes
+ *
+ * @return  char
+ */
+char DrawCharOpaque(char character, uint16_t color, uint16_t background, ESizes size)
+{
+  // cell background
+  DrawRectangle(cacheMemIndexCol, cacheMemIndexCol + (CHARS_COLS_LEN + 1) * (size & 0x0F) - 1,
+                cacheMemIndexRow, cacheMemIndexRow + CHARS_ROWS_LEN * (size >> 4) - 1, background);
+  // character
+  return DrawChar(character, color, size);
+}
+
+/**
+ * @desc    Draw string with background
+ *
+ * @param   const char * string
+ * @param   uint16_t color
+ * @param   uint16_t background
+ * @param   ESizes
+ *
+ * @return  void
+ */
+void DrawStringOpaque(const char *str, uint16_t color, uint16_t background, ESizes size)
+{
+  // width of cell
+  uint8_t cell = (CHARS_COLS_LEN + 1) * (size & 0x0F);
+
+  // loop through character of string
+  while (*str != '\0') {
+    // control if will be in range
+    if (SSD1306_SUCCESS != CheckPosition(cacheMemIndexCol + cell, cacheMemIndexRow, size)) {
+      return;
+    }
+    // read characters and increment index
+    DrawCharOpaque(*str++, color, background, size);
+    // update position
+    cacheMemIndexCol += cell;
+  }
+}
+
+/**
+ * @desc    Clear screen - whole framebuffer dirty
+ *
+ * @param   uint16_t color
+ *
+ * @return  void
+ */
+void ClearScreen(uint16_t color)
+{
+  uint8_t page;
+
+  // fill
+  memset(ssd1306Buffer, (color != BLACK) ? 0xFF : 0x00, sizeof(ssd1306Buffer));
+  // whole pages dirty
+  for (page = 0; page < SSD1306_PAGES; page++) {
+    ssd1306First[page] = 0;
+    ssd1306Last[page] = SSD1306_WIDTH - 1;
+  }
+}
+
+/**
+ * @desc    Update screen - flush framebuffer
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+void UpdateScreen(void)
+{
+  // dirty pages to display
+  Ssd1306Flush();
+}
@@ -0,0 +1,260 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        SSD1306 OLED driver - page framebuffer over TWI
+ * -------------------------------------------------------------+
+ *
+ * @file        ssd1306.h
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+
+ */
+
+#include <stdint.h>
+#if defined(__AVR__)
+  #include <avr/io.h>
+#endif
+
+#ifndef __SSD1306_H__
+#define __SSD1306_H__
+
+  // 7 bit address, 0x3D with SA0 high
+  #ifndef SSD1306_ADDRESS
+    #define SSD1306_ADDRESS 0x3C
+  #endif
+
+  // columns
+  #define SSD1306_WIDTH   128
+  // rows - 128x64 framebuffer takes 1 KB, whole RAM of Atmega16,
+  //        128x32 (512 B) used on parts with less than 2 KB RAM
+  #ifndef SSD1306_HEIGHT
+    #if defined(RAMEND) && (RAMEND < 0x800)
+      #define SSD1306_HEIGHT 32
+    #else
+      #define SSD1306_HEIGHT 64
+    #endif
+  #endif
+  // pages of 8 rows
+  #define SSD1306_PAGES   (SSD1306_HEIGHT >> 3)
+
+  // control byte - command stream / data stream
+  #define SSD1306_COMMAND 0x00
+  #define SSD1306_DATA    0x40
+
+  // Commands
+  #define SSD1306_MEMORY_MODE     0x20
+  #define SSD1306_COLUMN_ADDR     0x21
+  #define SSD1306_PAGE_ADDR       0x22
+  #define SSD1306_START_LINE      0x40
+  #define SSD1306_CONTRAST        0x81
+  #define SSD1306_CHARGE_PUMP     0x8D
+  #define SSD1306_SEG_REMAP       0xA1
+  #define SSD1306_DISPLAY_RAM     0xA4
+  #define SSD1306_NORMAL          0xA6
+  #define SSD1306_MULTIPLEX       0xA8
+  #define SSD1306_DISPLAY_OFF     0xAE
+  #define SSD1306_DISPLAY_ON      0xAF
+  #define SSD1306_COM_SCAN_DEC    0xC8
+  #define SSD1306_DISPLAY_OFFSET  0xD3
+  #define SSD1306_CLOCK_DIV       0xD5
+  #define SSD1306_PRECHARGE       0xD9
+  #define SSD1306_COM_PINS        0xDA
+  #define SSD1306_VCOM_DETECT     0xDB
+
+  // Colors - pixel on for any color except black
+  #define BLACK   0x0000
+  #define WHITE   0xFFFF
+  #define RED     0xF000
+
+  #define SSD1306_SUCCESS 0
+  #define SSD1306_ERROR   1
+
+  // max columns
+  #define MAX_X   SSD1306_WIDTH
+  // max rows
+  #define MAX_Y   SSD1306_HEIGHT
+  // columns max counter
+  #define SIZE_X  MAX_X - 1
+  // rows max counter
+  #define SIZE_Y  MAX_Y - 1
+  // number of columns for chars
+  #define CHARS_COLS_LEN 5
+  // number of rows for chars
+  #define CHARS_ROWS_LEN 8
+
+  /** @enum Font sizes */
+  typedef enum {
+    // 1x high & 1x wide size
+    X1 = 0x11,
+    // 2x high & 1x wide size
+    X2 = 0x21,
+    // 2x high & 2x wider size
+    X3 = 0x22
+  } ESizes;
+
+  /** @var Bytes sent by last UpdateScreen, SLA and control bytes included */
+  extern uint16_t ssd1306Bytes;
+
+  /**
+   * @desc    Init display - commands sent, framebuffer cleared
+   *
+   * @param   void
+   *
+   * @return  uint8_t
+   */
+  uint8_t Ssd1306Init(void);
+
+  /**
+   * @desc    Flush dirty columns of pages - one data write per page
+   *
+   * @param   void
+   *
+   * @return  uint8_t
+   */
+  uint8_t Ssd1306Flush(void);
+
+  /**
+   * @desc    Set text position
+   *
+   * @param   uint8_t x
+   * @param   uint8_t y
+   *
+   * @return  char
+   */
+  char SetPosition(uint8_t, uint8_t);
+
+  /**
+   * @desc    Check text position, wrap to next line
+   *
+   * @param   uint8_t x
+   * @param   uint8_t y
+   * @param   ESizes
+   *
+   * @return  char
+   */
+  char CheckPosition(uint8_t, uint8_t, ESizes);
+
+  /**
+   * @desc    Draw pixel
+   *
+   * @param   uint8_t x
+   * @param   uint8_t y
+   * @param   uint16_t color
+   *
+   * @return  void
+   */
+  void DrawPixel(uint8_t, uint8_t, uint16_t);
+
+  /**
+   * @desc    Draw character
+   *
+   * @param   char character
+   * @param   uint16_t color
+   * @param   ESizes
+   *
+   * @return  char
+   */
+  char DrawChar(char, uint16_t, ESizes);
+
+  /**
+   * @desc    Draw string
+   *
+   * @param   const char * string
+   * @param   uint16_t color
+   * @param   ESizes
+   *
+   * @return  void
+   */
+  void DrawString(volatile const char*, uint16_t, ESizes);
+
+  /**
+   * @desc    Draw character with background
+   *
+   * @param   char character
+   * @param   uint16_t color
+   * @param   uint16_t background
+   * @param   ESizes
+   *
+   * @return  char
+   */
+  char DrawCharOpaque(char, uint16_t, uint16_t, ESizes);
+
+  /**
+   * @desc    Draw string with background
+   *
+   * @param   const char * string
+   * @param   uint16_t color
+   * @param   uint16_t background
+   * @param   ESizes
+   *
+   * @return  void
+   */
+  void DrawStringOpaque(const char*, uint16_t, uint16_t, ESizes);
+
+  /**
+   * @desc    Draw line
+   *
+   * @param   uint8_t x start
+   * @param   uint8_t x end
+   * @param   uint8_t y start
+   * @param   uint8_t y end
+   * @param   uint16_t color
+   *
+   * @return  char
+   */
+  char DrawLine(uint8_t, uint8_t, uint8_t, uint8_t, uint16_t);
+
+  /**
+   * @desc    Draw horizontal line
+   *
+   * @param   uint8_t x start
+   * @param   uint8_t x end
+   * @param   uint8_t y
+   * @param   uint16_t color
+   *
+   * @return  void
+   */
+  void DrawLineHorizontal(uint8_t, uint8_t, uint8_t, uint16_t);
+
+  /**
+   * @desc    Draw vertical line
+   *
+   * @param   uint8_t x
+   * @param   uint8_t y start
+   * @param   uint8_t y end
+   * @param   uint16_t color
+   *
+   * @return  void
+   */
+  void DrawLineVertical(uint8_t, uint8_t, uint8_t, uint16_t);
+
+  /**
+   * @desc    Draw filled rectangle
+   *
+   * @param   uint8_t x start
+   * @param   uint8_t x end
+   * @param   uint8_t y start
+   * @param   uint8_t y end
+   * @param   uint16_t color
+   *
+   * @return  void
+   */
+  void DrawRectangle(uint8_t, uint8_t, uint8_t, uint8_t, uint16_t);
+
+  /**
+   * @desc    Clear screen
+   *
+   * @param   uint16_t color
+   *
+   * @return  void
+   */
+  void ClearScreen(uint16_t);
+
+  /**
+   * @desc    Update screen - flush framebuffer
+   *
+   * @param   void
+   *
+   * @return  void
+   */
+  void UpdateScreen(void);
+
+#endif
@@ -20,161 +20,147 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <avr/io.h>
-#include <avr/pgmspace.h>
-#include <util/delay.h>
-#include "st7735.h"
-
-/** @array Init command */
-const uint8_t INIT_ST7735B[] PROGMEM = {
-  // number of initializers
-  5,
-  // ---------------------------------------
-  // Software reset - no arguments,  delay
-  0, 150, SWRESET,
-  // Out of sleep mode, no arguments, delay
-  0, 200, SLPOUT,  
-  // Set color mode, 1 argument delay
-  1,  10, COLMOD, 0x05,
-  // D7  D6  D5  D4  D3  D2  D1  D0
-  // MY  MX  MV  ML RGB  MH   -   -
-  // ------------------------------
-  // ------------------------------
-  // MV  MX  MY -> {MV (row / column exchange) MX (column address order), MY (row address order)}
-  // ------------------------------
-  //  0   0   0 -> begin left-up corner, end right-down corner 
-  //               left-right (normal view) 
-  //  0   0   1 -> begin left-down corner, end right-up corner 
-  //               left-right (Y-mirror)
-  //  0   1   0 -> begin right-up corner, end left-down corner 
-  //               right-left (X-mirror)
-  //  0   1   1 -> begin right-down corner, end left-up corner
-  //               right-left (X-mirror, Y-mirror)
-  //  1   0   0 -> begin left-up corner, end right-down corner
-  //               up-down (X-Y exchange)  
-  //  1   0   1 -> begin left-down corner, end right-up corner
-  //               down-up (X-Y exchange, Y-mirror)
-  //  1   1   0 -> begin right-up corner, end left-down corner 
-  //               up-down (X-Y exchange, X-mirror)  
-  //  1   1   1 -> begin right-down corner, end left-up corner
-  //               down-up (X-Y exchange, X-mirror, Y-mirror)
-  // ------------------------------
-  //  ML: vertical refresh order 
-  //      0 -> refresh top to bottom 
-  //      1 -> refresh bottom to top
-  // ------------------------------
-  // RGB: filter panel
-  //      0 -> RGB 
-  //      1 -> BGR        
-  // ------------------------------ 
-  //  MH: horizontal refresh order 
-  //      0 -> refresh left to right 
-  //      1 -> refresh right to left
-  // 0xA0 = 1010 0000
-  1,   0, MADCTL, 0xA0,
-  // Main screen turn on
-  0, 200, DISPON 
-  // ---------------------------------------
+#if defined(__AVR__)
+  #include <avr/io.h>
+  #include <avr/pgmspace.h>
+#endif
+#include "display.h"
+#include "font.h"
+#include "sched.h"
+#include "perf.h"
+
+#if (ST7735_SPI_DIV != 2) && (ST7735_SPI_DIV != 4) && (ST7735_SPI_DIV != 8) && (ST7735_SPI_DIV != 16) && \
+    (ST7735_SPI_DIV != 32) && (ST7735_SPI_DIV != 64) && (ST7735_SPI_DIV != 128)
+  #error "ST7735_SPI_DIV has to be 2, 4, 8, 16, 32, 64 or 128"
+#endif
+
+// interrupt per byte at 16 or 32 cycles per byte takes more CPU than polling
+#if defined(ST7735_ASYNC) && (ST7735_SPI_DIV < 16)
+  #error "ST7735_ASYNC needs ST7735_SPI_DIV 16 or more"
+#endif
+
+#if defined(ST7735_ASYNC) && defined(__AVR__)
+  #include <avr/interrupt.h>
+  #include <avr/sleep.h>
+  #include <util/atomic.h>
+#endif
+
+/** @def Init list ST7735B - CMD(command, arguments),
+ *        CMD_DELAY(ms, command, arguments)
+ */
+#define INIT_ST7735B(CMD, CMD_DELAY) \
+  /* Software reset */ \
+  CMD_DELAY(150, SWRESET) \
+  /* Out of sleep mode */ \
+  CMD_DELAY(200, SLPOUT) \
+  /* Set color mode - 16 / 12 bits */ \
+  CMD_DELAY(10, COLMOD, ST7735_COLMOD) \
+  /* Memory access control */ \
+  CMD(MADCTL, ST7735_MADCTL) \
+  /* Main screen turn on */ \
+  CMD_DELAY(200, DISPON)
+
+/** @def Init list ST7735R / ST7735S */
+#define INIT_ST7735R(CMD, CMD_DELAY) \
+  /* Software reset */ \
+  CMD_DELAY(150, SWRESET) \
+  /* Out of sleep mode */ \
+  CMD_DELAY(255, SLPOUT) \
+  /* Frame rate - normal, idle, partial mode */ \
+  CMD(FRMCTR1, 0x01, 0x2C, 0x2D) \
+  CMD(FRMCTR2, 0x01, 0x2C, 0x2D) \
+  CMD(FRMCTR3, 0x01, 0x2C, 0x2D, 0x01, 0x2C, 0x2D) \
+  /* Display inversion - no inversion */ \
+  CMD(INVCTR, 0x07) \
+  /* Power control */ \
+  CMD(PWCTR1, 0xA2, 0x02, 0x84) \
+  CMD(PWCTR2, 0xC5) \
+  CMD(PWCTR3, 0x0A, 0x00) \
+  CMD(PWCTR4, 0x8A, 0x2A) \
+  CMD(PWCTR5, 0x8A, 0xEE) \
+  CMD(VMCTR1, 0x0E) \
+  CMD(INVOFF) \
+  /* Memory access control */ \
+  CMD(MADCTL, ST7735_MADCTL) \
+  /* Set color mode - 16 / 12 bits */ \
+  CMD(COLMOD, ST7735_COLMOD) \
+  /* Gamma */ \
+  CMD(GMCTRP1, 0x02, 0x1C, 0x07, 0x12, 0x37, 0x32, 0x29, 0x2D, \
+               0x29, 0x25, 0x2B, 0x39, 0x00, 0x01, 0x03, 0x10) \
+  CMD(GMCTRN1, 0x03, 0x1D, 0x07, 0x06, 0x2E, 0x2C, 0x29, 0x2D, \
+               0x2E, 0x2E, 0x37, 0x3F, 0x00, 0x00, 0x02, 0x10) \
+  /* Normal display on */ \
+  CMD_DELAY(10, NORON) \
+  /* Main screen turn on */ \
+  CMD_DELAY(100, DISPON)
+
+// MADCTL
+// D7  D6  D5  D4  D3  D2  D1  D0
+// MY  MX  MV  ML RGB  MH   -   -
+// ------------------------------
+// ------------------------------
+// MV  MX  MY -> {MV (row / column exchange) MX (column address order), MY (row address order)}
+// ------------------------------
+//  0   0   0 -> begin left-up corner, end right-down corner 
+//               left-right (normal view) 
+//  0   0   1 -> begin left-down corner, end right-up corner 
+//               left-right (Y-mirror)
+//  0   1   0 -> begin right-up corner, end left-down corner 
+//               right-left (X-mirror)
+//  0   1   1 -> begin right-down corner, end left-up corner
+//               right-left (X-mirror, Y-mirror)
+//  1   0   0 -> begin left-up corner, end right-down corner
+//               up-down (X-Y exchange)  
+//  1   0   1 -> begin left-down corner, end right-up corner
+//               down-up (X-Y exchange, Y-mirror)
+//  1   1   0 -> begin right-up corner, end left-down corner 
+//               up-down (X-Y exchange, X-mirror)  
+//  1   1   1 -> begin right-down corner, end left-up corner
+//               down-up (X-Y exchange, X-mirror, Y-mirror)
+// ------------------------------
+//  ML: vertical refresh order 
+//      0 -> refresh top to bottom 
+//      1 -> refresh bottom to top
+// ------------------------------
+// RGB: filter panel
+//      0 -> RGB 
+//      1 -> BGR        
+// ------------------------------ 
+//  MH: horizontal refresh order 
+//      0 -> refresh left to right 
+//      1 -> refresh right to left
+// 0xA0 = 1010 0000
+
+/** @array Init command - list of selected variant only */
+const uint8_t INIT_ST7735[] PROGMEM = {
+#if ST7735_VARIANT == ST7735_R
+  ST7735_INIT_LIST(INIT_ST7735R)
+#else
+  ST7735_INIT_LIST(INIT_ST7735B)
+#endif
+};
+
+/** @def Glyph columns */
+#define GLYPH_COLS(c0, c1, c2, c3, c4) { c0, c1, c2, c3, c4 },
+/** @def Glyph row - column 0 in bit 7, bits 2..0 clear (gap column) */
+#define GLYPH_ROW(r, c0, c1, c2, c3, c4) \
+  ((((c0) >> (r)) & 1) << 7 | (((c1) >> (r)) & 1) << 6 | (((c2) >> (r)) & 1) << 5 | \
+   (((c3) >> (r)) & 1) << 4 | (((c4) >> (r)) & 1) << 3)
+/** @def Glyph rows */
+#define GLYPH_ROWS(c0, c1, c2, c3, c4) { \
+  GLYPH_ROW(0, c0, c1, c2, c3, c4), GLYPH_ROW(1, c0, c1, c2, c3, c4), \
+  GLYPH_ROW(2, c0, c1, c2, c3, c4), GLYPH_ROW(3, c0, c1, c2, c3, c4), \
+  GLYPH_ROW(4, c0, c1, c2, c3, c4), GLYPH_ROW(5, c0, c1, c2, c3, c4), \
+  GLYPH_ROW(6, c0, c1, c2, c3, c4), GLYPH_ROW(7, c0, c1, c2, c3, c4) },
+
+/** @array Charset - column bytes, per pixel drawing */
+const uint8_t CHARACTERS[][CHARS_COLS_LEN] PROGMEM = {
+  FONT_5X8(GLYPH_COLS)
 };
 
-/** @array Charset */
-const uint8_t CHARACTERS[][5] PROGMEM = {
-  { 0x00, 0x00, 0x00, 0x00, 0x00 }, // 20 space
-  { 0x00, 0x00, 0x5f, 0x00, 0x00 }, // 21 !
-  { 0x00, 0x07, 0x00, 0x07, 0x00 }, // 22 "
-  { 0x14, 0x7f, 0x14, 0x7f, 0x14 }, // 23 #
-  { 0x24, 0x2a, 0x7f, 0x2a, 0x12 }, // 24 $
-  { 0x23, 0x13, 0x08, 0x64, 0x62 }, // 25 %
-  { 0x36, 0x49, 0x55, 0x22, 0x50 }, // 26 &
-  { 0x00, 0x05, 0x03, 0x00, 0x00 }, // 27 '
-  { 0x00, 0x1c, 0x22, 0x41, 0x00 }, // 28 (
-  { 0x00, 0x41, 0x22, 0x1c, 0x00 }, // 29 )
-  { 0x14, 0x08, 0x3e, 0x08, 0x14 }, // 2a *
-  { 0x08, 0x08, 0x3e, 0x08, 0x08 }, // 2b +
-  { 0x00, 0x50, 0x30, 0x00, 0x00 }, // 2c ,
-  { 0x08, 0x08, 0x08, 0x08, 0x08 }, // 2d -
-  { 0x00, 0x60, 0x60, 0x00, 0x00 }, // 2e .
-  { 0x20, 0x10, 0x08, 0x04, 0x02 }, // 2f /
-  { 0x3e, 0x51, 0x49, 0x45, 0x3e }, // 30 0
-  { 0x00, 0x42, 0x7f, 0x40, 0x00 }, // 31 1
-  { 0x42, 0x61, 0x51, 0x49, 0x46 }, // 32 2
-  { 0x21, 0x41, 0x45, 0x4b, 0x31 }, // 33 3
-  { 0x18, 0x14, 0x12, 0x7f, 0x10 }, // 34 4
-  { 0x27, 0x45, 0x45, 0x45, 0x39 }, // 35 5
-  { 0x3c, 0x4a, 0x49, 0x49, 0x30 }, // 36 6
-  { 0x01, 0x71, 0x09, 0x05, 0x03 }, // 37 7
-  { 0x36, 0x49, 0x49, 0x49, 0x36 }, // 38 8
-  { 0x06, 0x49, 0x49, 0x29, 0x1e }, // 39 9
-  { 0x00, 0x36, 0x36, 0x00, 0x00 }, // 3a :
-  { 0x00, 0x56, 0x36, 0x00, 0x00 }, // 3b ;
-  { 0x08, 0x14, 0x22, 0x41, 0x00 }, // 3c <
-  { 0x14, 0x14, 0x14, 0x14, 0x14 }, // 3d =
-  { 0x00, 0x41, 0x22, 0x14, 0x08 }, // 3e >
-  { 0x02, 0x01, 0x51, 0x09, 0x06 }, // 3f ?
-  { 0x32, 0x49, 0x79, 0x41, 0x3e }, // 40 @
-  { 0x7e, 0x11, 0x11, 0x11, 0x7e }, // 41 A
-  { 0x7f, 0x49, 0x49, 0x49, 0x36 }, // 42 B
-  { 0x3e, 0x41, 0x41, 0x41, 0x22 }, // 43 C
-  { 0x7f, 0x41, 0x41, 0x22, 0x1c }, // 44 D
-  { 0x7f, 0x49, 0x49, 0x49, 0x41 }, // 45 E
-  { 0x7f, 0x09, 0x09, 0x09, 0x01 }, // 46 F
-  { 0x3e, 0x41, 0x49, 0x49, 0x7a }, // 47 G
-  { 0x7f, 0x08, 0x08, 0x08, 0x7f }, // 48 H
-  { 0x00, 0x41, 0x7f, 0x41, 0x00 }, // 49 I
-  { 0x20, 0x40, 0x41, 0x3f, 0x01 }, // 4a J
-  { 0x7f, 0x08, 0x14, 0x22, 0x41 }, // 4b K
-  { 0x7f, 0x40, 0x40, 0x40, 0x40 }, // 4c L
-  { 0x7f, 0x02, 0x0c, 0x02, 0x7f }, // 4d M
-  { 0x7f, 0x04, 0x08, 0x10, 0x7f }, // 4e N
-  { 0x3e, 0x41, 0x41, 0x41, 0x3e }, // 4f O
-  { 0x7f, 0x09, 0x09, 0x09, 0x06 }, // 50 P
-  { 0x3e, 0x41, 0x51, 0x21, 0x5e }, // 51 Q
-  { 0x7f, 0x09, 0x19, 0x29, 0x46 }, // 52 R
-  { 0x46, 0x49, 0x49, 0x49, 0x31 }, // 53 S
-  { 0x01, 0x01, 0x7f, 0x01, 0x01 }, // 54 T
-  { 0x3f, 0x40, 0x40, 0x40, 0x3f }, // 55 U
-  { 0x1f, 0x20, 0x40, 0x20, 0x1f }, // 56 V
-  { 0x3f, 0x40, 0x38, 0x40, 0x3f }, // 57 W
-  { 0x63, 0x14, 0x08, 0x14, 0x63 }, // 58 X
-  { 0x07, 0x08, 0x70, 0x08, 0x07 }, // 59 Y
-  { 0x61, 0x51, 0x49, 0x45, 0x43 }, // 5a Z
-  { 0x00, 0x7f, 0x41, 0x41, 0x00 }, // 5b [
-  { 0x02, 0x04, 0x08, 0x10, 0x20 }, // 5c backslash
-  { 0x00, 0x41, 0x41, 0x7f, 0x00 }, // 5d ]
-  { 0x04, 0x02, 0x01, 0x02, 0x04 }, // 5e ^
-  { 0x40, 0x40, 0x40, 0x40, 0x40 }, // 5f _
-  { 0x00, 0x01, 0x02, 0x04, 0x00 }, // 60 `
-  { 0x20, 0x54, 0x54, 0x54, 0x78 }, // 61 a
-  { 0x7f, 0x48, 0x44, 0x44, 0x38 }, // 62 b
-  { 0x38, 0x44, 0x44, 0x44, 0x20 }, // 63 c
-  { 0x38, 0x44, 0x44, 0x48, 0x7f }, // 64 d
-  { 0x38, 0x54, 0x54, 0x54, 0x18 }, // 65 e
-  { 0x08, 0x7e, 0x09, 0x01, 0x02 }, // 66 f
-  { 0x0c, 0x52, 0x52, 0x52, 0x3e }, // 67 g
-  { 0x7f, 0x08, 0x04, 0x04, 0x78 }, // 68 h
-  { 0x00, 0x44, 0x7d, 0x40, 0x00 }, // 69 i
-  { 0x20, 0x40, 0x44, 0x3d, 0x00 }, // 6a j
-  { 0x7f, 0x10, 0x28, 0x44, 0x00 }, // 6b k
-  { 0x00, 0x41, 0x7f, 0x40, 0x00 }, // 6c l
-  { 0x7c, 0x04, 0x18, 0x04, 0x78 }, // 6d m
-  { 0x7c, 0x08, 0x04, 0x04, 0x78 }, // 6e n
-  { 0x38, 0x44, 0x44, 0x44, 0x38 }, // 6f o
-  { 0x7c, 0x14, 0x14, 0x14, 0x08 }, // 70 p
-  { 0x08, 0x14, 0x14, 0x14, 0x7c }, // 71 q
-  { 0x7c, 0x08, 0x04, 0x04, 0x08 }, // 72 r
-  { 0x48, 0x54, 0x54, 0x54, 0x20 }, // 73 s
-  { 0x04, 0x3f, 0x44, 0x40, 0x20 }, // 74 t
-  { 0x3c, 0x40, 0x40, 0x20, 0x7c }, // 75 u
-  { 0x1c, 0x20, 0x40, 0x20, 0x1c }, // 76 v
-  { 0x3c, 0x40, 0x30, 0x40, 0x3c }, // 77 w
-  { 0x44, 0x28, 0x10, 0x28, 0x44 }, // 78 x
-  { 0x0c, 0x50, 0x50, 0x50, 0x3c }, // 79 y
-  { 0x44, 0x64, 0x54, 0x4c, 0x44 }, // 7a z
-  { 0x00, 0x08, 0x36, 0x41, 0x00 }, // 7b {
-  { 0x00, 0x00, 0x7f, 0x00, 0x00 }, // 7c |
-  { 0x00, 0x41, 0x36, 0x08, 0x00 }, // 7d }
-  { 0x10, 0x08, 0x08, 0x10, 0x08 }, // 7e ~
-  { 0x00, 0x00, 0x00, 0x00, 0x00 }  // 7f
+/** @array Charset - row bytes transposed at compile time, window streaming */
+const uint8_t CHARACTERS_ROWS[][CHARS_ROWS_LEN] PROGMEM = {
+  FONT_5X8(GLYPH_ROWS)
 };
 
 /** @var array Chache memory char index row */
@@ -182,6 +168,29 @@ int cacheMemIndexRow = 0;
 /** @var array Chache memory char index column */
 int cacheMemIndexCol = 0;
 
+#if ST7735_COLOR_BITS == 12
+/** @var Pixel of stream waiting for pair */
+static uint16_t pixel;
+/** @var Pixel waiting */
+static uint8_t pixelPending = 0;
+#endif
+
+/** @array MADCTL of rotations - MY, MX, MV only, MV swaps columns and rows;
+ *         plain cycle, ST7735_MIRROR toggles MY */
+static const uint8_t ROTATIONS[] PROGMEM = { 0xA0, 0x00, 0x60, 0xC0 };
+// ML, RGB, MH of ST7735_MADCTL kept by every rotation - BGR panels
+#define MADCTL_BASE (ST7735_MADCTL & 0x1C)
+/** @var Size of current rotation - init list sets ST7735_MADCTL */
+uint8_t st7735Width = (ST7735_MADCTL & 0x20) ? ST7735_ROWS : ST7735_COLS;
+uint8_t st7735Height = (ST7735_MADCTL & 0x20) ? ST7735_COLS : ST7735_ROWS;
+
+/** @var Init step of St7735InitStep */
+static uint8_t initStep = 0;
+/** @var Next command of init list */
+static const uint8_t *initCommand;
+/** @var Commands left in init list */
+static uint8_t initLeft;
+
 /**
  * @desc    Hardware Reset Impulse - minimal time required 120 ms
  *
@@ -195,11 +204,11 @@ void HardwareReset(void)
   // DDR as output
   HW_RESET_DDR  |= (1 << HW_RESET_PIN); 
   // delay 200 ms
-  _delay_ms(200);
+  DelayMs(200);
   // Reset Low 
   HW_RESET_PORT &= ~(1 << HW_RESET_PIN);
   // delay 200 ms
-  _delay_ms(200);
+  DelayMs(200);
   // Reset High
   HW_RESET_PORT |=  (1 << HW_RESET_PIN);
 }
@@ -221,8 +230,20 @@ void SpiInit(void)
   // MSTR - Master device
   SPCR |= (1 << SPE) | 
           (1 << MSTR);
-  // SPI2X - Prescaler fclk/2 = 8MHz
+  // SPI2X, SPR1, SPR0 - Prescaler fclk/ST7735_SPI_DIV, 2 => 8MHz
+#if (ST7735_SPI_DIV == 2) || (ST7735_SPI_DIV == 8) || (ST7735_SPI_DIV == 32)
   SPSR |= (1 << SPI2X);
+#endif
+#if (ST7735_SPI_DIV == 8) || (ST7735_SPI_DIV == 16) || (ST7735_SPI_DIV == 128)
+  SPCR |= (1 << SPR0);
+#endif
+#if (ST7735_SPI_DIV >= 32)
+  SPCR |= (1 << SPR1);
+#endif
+#ifdef ST7735_ASYNC
+  // SPIE - SPI transfer complete interrupt drives queue
+  SPCR |= (1 << SPIE);
+#endif
 }
 
 /**
@@ -233,16 +254,134 @@ void SpiInit(void)
  */
 void St7735Init(void)
 {
-  // set DDR BackLigt
-  DDR  |= (1 << ST7735_BL);
-  // set high level on Backlight
-  PORT |= (1 << ST7735_BL);
-  // init spi
-  SpiInit();
-  // reset
-  HardwareReset();
-  // load list of commands
-  St7735Commands(INIT_ST7735B);
+  uint16_t time;
+
+  // steps with delays in between
+  while ((time = St7735InitStep()) != ST7735_INIT_DONE) {
+    // delay
+    DelayMs(time);
+  }
+}
+
+/**
+ * @desc    Initialise St7735 step by step - resumable by caller
+ *          backlight and reset, then one command per step
+ *
+ * @param   void
+ * @return  uint16_t delay in ms before next step / ST7735_INIT_DONE
+ */
+uint16_t St7735InitStep(void)
+{
+  uint8_t time;
+
+  // next step
+  switch (initStep++) {
+    // reset pin high
+    case 0:
+      // set DDR BackLigt
+      DDR  |= (1 << ST7735_BL);
+      // set high level on Backlight
+      PORT |= (1 << ST7735_BL);
+      // init spi
+      SpiInit();
+      // Actiavte pull-up register logical high on pin RST
+      HW_RESET_PORT |= (1 << HW_RESET_PIN);
+      // DDR as output
+      HW_RESET_DDR  |= (1 << HW_RESET_PIN); 
+      // delay 200 ms
+      return 200;
+    // reset low
+    case 1:
+      // Reset Low 
+      HW_RESET_PORT &= ~(1 << HW_RESET_PIN);
+      // delay 200 ms
+      return 200;
+    // reset high
+    case 2:
+      // Reset High
+      HW_RESET_PORT |=  (1 << HW_RESET_PIN);
+      // list of commands
+      initCommand = INIT_ST7735;
+      initLeft = pgm_read_byte(initCommand++);
+      // fall through
+    // commands
+    default:
+      // stay on command steps
+      initStep = 3;
+      // commands without delay sent in one step
+      while (initLeft) {
+        initLeft--;
+        // command and its delay
+        time = St7735Command(&initCommand);
+        // check if delay follows
+        if (time) {
+          return time;
+        }
+      }
+      // next init from beginning
+      initStep = 0;
+      // done
+      return ST7735_INIT_DONE;
+  }
+}
+
+/**
+ * @desc    Send one command of list
+ *
+ * @param   const uint8_t ** command in list, moved to next command
+ * @return  uint8_t delay in ms after command, 0 if none
+ */
+uint8_t St7735Command(const uint8_t **initializers)
+{
+  uint8_t args;
+  uint8_t cmnd;
+  uint8_t time = 0;
+
+  // 1st byte - command
+  cmnd = pgm_read_byte((*initializers)++);
+  // 2nd byte - number of command arguments, DELAY flag
+  args = pgm_read_byte((*initializers)++);
+
+  // send command
+  CommandSend(cmnd);
+  // send arguments
+  for (cmnd = args & ~DELAY; cmnd; cmnd--) {
+    // send argument
+    Data8BitsSend(pgm_read_byte((*initializers)++));
+  }
+  // check if delay follows
+  if (args & DELAY) {
+    // delay time
+    time = pgm_read_byte((*initializers)++);
+    // delay counts from command sent
+    St7735Flush();
+  }
+  // delay
+  return time;
+}
+
+/**
+ * @desc    Set rotation - controller maps coordinates, no cost per pixel
+ *
+ * @param   ERotation rotation
+ * @return  void
+ */
+void SetRotation(ERotation rotation)
+{
+  // cycle entered at ST7735_MADCTL - ROTATE_0 keeps init value
+  uint8_t madctl = (pgm_read_byte(&ROTATIONS[(rotation + ST7735_ROTATION) & 0x03]) ^ ST7735_MIRROR) | MADCTL_BASE;
+
+  // memory access control
+  CommandSend(MADCTL);
+  Data8BitsSend(madctl);
+  // MV - row / column exchange
+  if (madctl & 0x20) {
+    st7735Width = ST7735_ROWS;
+    st7735Height = ST7735_COLS;
+  } else {
+    st7735Width = ST7735_COLS;
+    st7735Height = ST7735_ROWS;
+  }
 }
 
 /**
@@ -253,34 +392,433 @@ void St7735Init(void)
  */
 void St7735Commands(const uint8_t *initializers)
 {
-  uint8_t args;
-  uint8_t cmnd;
-  uint8_t time;
   uint8_t loop = pgm_read_byte(initializers++);
 
   // loop through whole initializer list
   while (loop--) {
+    // send command and delay
+    DelayMs(St7735Command(&initializers));
+  }
+}
+
+#ifdef ST7735_ASYNC
+
+/** @def SPI queue operations */
+#define SPI_OP_COMMAND  0
+#define SPI_OP_DATA     1
+#define SPI_OP_COLOR    2
+#define SPI_OP_WORD     3
+
+/** @struct SPI queue entry - command, data byte or run of colors */
+typedef struct {
+  uint8_t op;
+  uint16_t value;
+  uint16_t count;
+} TSpiJob;
+
+/** @var SPI queue drained by SPI transfer complete interrupt */
+static volatile TSpiJob spiQueue[ST7735_QUEUE_SIZE];
+/** @var SPI queue write index */
+static volatile uint8_t spiHead = 0;
+/** @var SPI queue read index */
+static volatile uint8_t spiTail = 0;
+/** @var SPI transfer in progress */
+static volatile uint8_t spiBusy = 0;
+/** @var Byte of color run - 2 per pixel / 3 per pixel pair */
+static uint8_t spiPhase = 0;
 
-    // 1st arg - number of command arguments
-    args = pgm_read_byte(initializers++);
-    // 2nd arg - delay time
-    time = pgm_read_byte(initializers++);
-    // 3th arg - command
-    cmnd = pgm_read_byte(initializers++);
-
-    // send command
-    CommandSend(cmnd);
-    // send arguments
-    while (args--) {
-      // send argument
-      Data8BitsSend(pgm_read_byte(initializers++));
+#if DISPLAY_BACKEND == DISPLAY_HOST
+  // byte to host model with D/C of port
+  #define SPI_SEND(data)  HostSpiSend((data), PORT & (1 << ST7735_DC_LD))
+  // transfer complete, flag cleared
+  #define SPI_DONE()      HostSpiDone()
+#else
+  // byte to shift register
+  #define SPI_SEND(data)  SPDR = (data)
+  // transfer complete, flag cleared by SPSR then SPDR read
+  #define SPI_DONE()      ((SPSR & (1 << SPIF)) && ((void) SPDR, 1))
+#endif
+
+// pixel stream - bytes queued, chip select by queue
+#define PIXEL_SELECT()
+#define PIXEL_BYTE(data)  SpiEnqueue(SPI_OP_DATA, (data), 1)
+#define PIXEL_RELEASE()
+
+/**
+ * @desc    Send next byte from queue
+ *          called from ISR or with interrupts disabled
+ *
+ * @param   void
+ * @return  void
+ */
+static void SpiPump(void)
+{
+  volatile TSpiJob *job;
+
+  // queue empty
+  if (spiHead == spiTail) {
+    // chip disable - idle high
+    PORT |= (1 << ST7735_CS_LD);
+    // idle
+    spiBusy = 0;
+    return;
+  }
+  // one byte sent by every run
+  PERF_INC(spiBytes);
+  // oldest entry
+  job = &spiQueue[spiTail];
+  // command
+  if (job->op == SPI_OP_COMMAND) {
+    // command (active low)
+    PORT &= ~(1 << ST7735_DC_LD);
+    // transmitting command
+    SPI_SEND((uint8_t) job->value);
+    // entry done
+    spiTail = (spiTail + 1) & (ST7735_QUEUE_SIZE - 1);
+    return;
+  }
+  // data (active high)
+  PORT |= (1 << ST7735_DC_LD);
+  // 8 bits data
+  if (job->op == SPI_OP_DATA) {
+    // transmitting data
+    SPI_SEND((uint8_t) job->value);
+    // entry done
+    spiTail = (spiTail + 1) & (ST7735_QUEUE_SIZE - 1);
+#if ST7735_COLOR_BITS == 12
+  // color run - RRRRGGGG BBBBRRRR GGGGBBBB per pixel pair
+  } else if (job->op == SPI_OP_COLOR) {
+    // first pixel red green
+    if (spiPhase == 0) {
+      SPI_SEND((uint8_t) (job->value >> 4));
+      spiPhase = 1;
+    // first pixel blue, second pixel red
+    } else if (spiPhase == 1) {
+      SPI_SEND((uint8_t) ((job->value << 4) | ((job->value >> 8) & 0x0F)));
+      spiPhase = 2;
+      // odd pixel ends run
+      if (job->count == 1) {
+        spiPhase = 0;
+        // entry done
+        spiTail = (spiTail + 1) & (ST7735_QUEUE_SIZE - 1);
+      }
+    // second pixel green blue
+    } else {
+      SPI_SEND((uint8_t) job->value);
+      spiPhase = 0;
+      // run done
+      job->count -= 2;
+      if (job->count == 0) {
+        // entry done
+        spiTail = (spiTail + 1) & (ST7735_QUEUE_SIZE - 1);
+      }
+    }
+#endif
+  // color / word high byte
+  } else if (!spiPhase) {
+    // transmitting high byte
+    SPI_SEND((uint8_t) (job->value >> 8));
+    // low byte next
+    spiPhase = 1;
+  // color / word low byte
+  } else {
+    // transmitting low byte
+    SPI_SEND((uint8_t) job->value);
+    // high byte next
+    spiPhase = 0;
+    // run done
+    if (--job->count == 0) {
+      // entry done
+      spiTail = (spiTail + 1) & (ST7735_QUEUE_SIZE - 1);
     }
+  }
+}
 
-    // delay
-    DelayMs(time);
+/**
+ * @desc    SPI transfer complete - send next byte
+ *
+ * @param   SPI_STC_vect
+ * @return  void
+ */
+ISR(SPI_STC_vect)
+{
+  // next byte
+  SpiPump();
+}
+
+/**
+ * @desc    Wait for SPI - with interrupts disabled transfer complete
+ *          flag polled and next byte sent here
+ *
+ * @param   void
+ * @return  void
+ */
+static void SpiWait(void)
+{
+  // interrupt sends
+  if (SREG & (1 << SREG_I)) {
+#if DISPLAY_BACKEND == DISPLAY_HOST
+    // time passes in model
+    HostSpiWait();
+#endif
+    return;
+  }
+  // polled
+  if (SPI_DONE()) {
+    SpiPump();
+  }
+}
+
+/**
+ * @desc    Put entry to SPI queue, waits only when queue is full
+ *
+ * @param   uint8_t   operation
+ * @param   uint16_t  value
+ * @param   uint16_t  count
+ * @return  void
+ */
+static void SpiEnqueue(uint8_t op, uint16_t value, uint16_t count)
+{
+  uint8_t head = spiHead;
+  uint8_t next = (head + 1) & (ST7735_QUEUE_SIZE - 1);
+
+  // wait till entry is free
+  while (next == spiTail) {
+    SpiWait();
+  }
+  // fill entry
+  spiQueue[head].op = op;
+  spiQueue[head].value = value;
+  spiQueue[head].count = count;
+  // publish entry and start transfer if idle
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    // entry ready
+    spiHead = next;
+    // start transfer
+    if (!spiBusy) {
+      // busy
+      spiBusy = 1;
+      // chip enable - active low
+      PORT &= ~(1 << ST7735_CS_LD);
+      PERF_INC(spiSelects);
+      // first byte
+      SpiPump();
+    }
   }
 }
 
+/**
+ * @desc    Command send
+ *
+ * @param   uint8_t command
+ * @return  uint8_t
+ */
+uint8_t CommandSend(uint8_t data)
+{
+  // queue command
+  SpiEnqueue(SPI_OP_COMMAND, data, 1);
+  // nothing received
+  return 0;
+}
+
+/**
+ * @desc    8 bits data send
+ *
+ * @param   uint8_t 
+ * @return  uint8_t
+ */
+uint8_t Data8BitsSend(uint8_t data)
+{
+  // queue data
+  SpiEnqueue(SPI_OP_DATA, data, 1);
+  // nothing received
+  return 0;
+}
+
+/**
+ * @desc    16 bits data send
+ *
+ * @param   uint16_t 
+ * @return  uint8_t
+ */
+uint8_t Data16BitsSend(uint16_t data)
+{
+  // queue data as run of one
+  SpiEnqueue(SPI_OP_WORD, data, 1);
+  // nothing received
+  return 0;
+}
+
+/**
+ * @desc    Write color pixels - one queue entry for whole run
+ *
+ * @param   uint16_t color
+ * @param   uint16_t counter
+ *
+ * @return  void
+ */
+void SendColor565(uint16_t color, uint16_t count)
+{
+  // access to RAM
+  CommandSend(RAMWR);
+  PERF_ADD(pixels, count);
+  // check if any pixel
+  if (count) {
+    // queue run
+    SpiEnqueue(SPI_OP_COLOR, color, count);
+  }
+}
+
+/**
+ * @desc    Stream pixel after RAMWR, pairs packed in 12 bits mode
+ *
+ * @param   uint16_t color
+ * @return  void
+ */
+void SendPixel(uint16_t color)
+{
+  PERF_INC(pixels);
+#if ST7735_COLOR_BITS == 12
+  // first of pair waits
+  if (!pixelPending) {
+    pixel = color;
+    pixelPending = 1;
+    return;
+  }
+  pixelPending = 0;
+  // pair in 3 bytes
+  SpiEnqueue(SPI_OP_DATA, pixel >> 4, 1);
+  SpiEnqueue(SPI_OP_DATA, (uint8_t) (pixel << 4) | (color >> 8), 1);
+  SpiEnqueue(SPI_OP_DATA, (uint8_t) color, 1);
+#else
+  // pixel in 2 bytes
+  SpiEnqueue(SPI_OP_COLOR, color, 1);
+#endif
+}
+
+/**
+ * @desc    Wait till SPI queue is sent
+ *
+ * @param   void
+ * @return  void
+ */
+void St7735Flush(void)
+{
+  // caller state
+  uint8_t sreg = SREG;
+
+  // interrupts disabled - polled, never enabled here
+  if (!(sreg & (1 << SREG_I))) {
+    while (spiBusy) {
+      SpiWait();
+    }
+    return;
+  }
+  // idle sleep till queue drained - SPI interrupt wakes
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    while (spiBusy) {
+      sleep_enable();
+      sei();
+      sleep_cpu();
+      sleep_disable();
+      cli();
+    }
+  }
+}
+
+#else
+
+#if DISPLAY_BACKEND == DISPLAY_HOST
+
+// pixel stream - bytes to host model
+#define PIXEL_SELECT()
+#define PIXEL_BYTE(data)  Data8BitsSend(data)
+#define PIXEL_RELEASE()
+
+/**
+ * @desc    Command send - to host model of controller
+ *
+ * @param   uint8_t command
+ * @return  void
+ */
+uint8_t CommandSend(uint8_t data)
+{
+  // D/C low
+  HostLcdCommand(data);
+  PERF_INC(spiBytes);
+  // nothing received
+  return 0;
+}
+
+/**
+ * @desc    8 bits data send - to host model of controller
+ *
+ * @param   uint8_t
+ * @return  void
+ */
+uint8_t Data8BitsSend(uint8_t data)
+{
+  // D/C high
+  HostLcdData(data);
+  PERF_INC(spiBytes);
+  // nothing received
+  return 0;
+}
+
+/**
+ * @desc    16 bits data send - to host model of controller
+ *
+ * @param   uint16_t
+ * @return  void
+ */
+uint8_t Data16BitsSend(uint16_t data)
+{
+  // high byte first
+  HostLcdData((uint8_t) (data >> 8));
+  HostLcdData((uint8_t) data);
+  PERF_ADD(spiBytes, 2);
+  // nothing received
+  return 0;
+}
+
+/**
+ * @desc    Send color n times - to host model of controller
+ *
+ * @param   uint16_t color
+ * @param   uint16_t count
+ * @return  void
+ */
+void SendColor565(uint16_t color, uint16_t count)
+{
+  // access to RAM
+  CommandSend(RAMWR);
+  // pixels
+  while (count--) {
+    SendPixel(color);
+  }
+  // unpaired pixel
+  SendPixelEnd();
+}
+
+#else
+
+// pixel stream - chip selected once per RAMWR burst, released by
+// SendPixelEnd; command or data send in between releases it too
+#define PIXEL_SELECT()    do { \
+                            if (PORT & (1 << ST7735_CS_LD)) { \
+                              PERF_INC(spiSelects); \
+                              PORT &= ~(1 << ST7735_CS_LD); \
+                              PORT |= (1 << ST7735_DC_LD); \
+                            } \
+                          } while (0)
+#define PIXEL_BYTE(data)  do { \
+                            PERF_INC(spiBytes); \
+                            SPDR = (data); \
+                            while (!(SPSR & (1 << SPIF))); \
+                          } while (0)
+#define PIXEL_RELEASE()   PORT |= (1 << ST7735_CS_LD)
+
 /**
  * @desc    Command send
  *
@@ -289,6 +827,8 @@ void St7735Commands(const uint8_t *initializers)
  */
 uint8_t CommandSend(uint8_t data)
 {
+  PERF_INC(spiSelects);
+  PERF_INC(spiBytes);
   // chip enable - active low
   PORT &= ~(1 << ST7735_CS_LD);
   // command (active low)
@@ -311,6 +851,8 @@ uint8_t CommandSend(uint8_t data)
  */
 uint8_t Data8BitsSend(uint8_t data)
 {
+  PERF_INC(spiSelects);
+  PERF_INC(spiBytes);
   // chip enable - active low
   PORT &= ~(1 << ST7735_CS_LD);
   // data (active high)
@@ -333,6 +875,8 @@ uint8_t Data8BitsSend(uint8_t data)
  */
 uint8_t Data16BitsSend(uint16_t data)
 {
+  PERF_INC(spiSelects);
+  PERF_ADD(spiBytes, 2);
   // chip enable - active low
   PORT &= ~(1 << ST7735_CS_LD);
   // data (active high)
@@ -351,6 +895,209 @@ uint8_t Data16BitsSend(uint16_t data)
   return SPDR;
 }
 
+/**
+ * @desc    Write color pixels
+ *
+ * @param   uint16_t color
+ * @param   uint16_t counter
+ *
+ * @return  void
+ */
+void SendColor565(uint16_t color, uint16_t count)
+{
+#if ST7735_COLOR_BITS == 12
+  // bytes of pixel pair - RRRRGGGG BBBBRRRR GGGGBBBB
+  uint8_t first = (uint8_t) (color >> 4);
+  uint8_t second = (uint8_t) ((color << 4) | ((color >> 8) & 0x0F));
+  uint8_t third = (uint8_t) color;
+
+  // access to RAM
+  CommandSend(RAMWR);
+  PERF_ADD(pixels, count);
+  PERF_INC(spiSelects);
+  PERF_ADD(spiBytes, (count >> 1) * 3 + (count & 1) * 2);
+  // chip enable - active low
+  PORT &= ~(1 << ST7735_CS_LD);
+  // data (active high)
+  PORT |= (1 << ST7735_DC_LD);
+  // pixel pairs
+  for (; count > 1; count -= 2) {
+    SPDR = first;
+    while (!(SPSR & (1 << SPIF)));
+    SPDR = second;
+    while (!(SPSR & (1 << SPIF)));
+    SPDR = third;
+    while (!(SPSR & (1 << SPIF)));
+  }
+  // odd pixel - controller ignores unpaired nibble
+  if (count) {
+    SPDR = first;
+    while (!(SPSR & (1 << SPIF)));
+    SPDR = second;
+    while (!(SPSR & (1 << SPIF)));
+  }
+  // chip disable - idle high
+  PORT |= (1 << ST7735_CS_LD);
+#else
+  // access to RAM
+  CommandSend(RAMWR);
+  PERF_ADD(pixels, count);
+  PERF_INC(spiSelects);
+  PERF_ADD(spiBytes, count << 1);
+  // chip enable - active low
+  PORT &= ~(1 << ST7735_CS_LD);
+  // data (active high)
+  PORT |= (1 << ST7735_DC_LD);
+  // counter
+  while (count--) {
+    // write color - high byte first
+    SPDR = (uint8_t) (color >> 8);
+    while (!(SPSR & (1 << SPIF)));
+    SPDR = (uint8_t) color;
+    while (!(SPSR & (1 << SPIF)));
+  }
+  // chip disable - idle high
+  PORT |= (1 << ST7735_CS_LD);
+#endif
+}
+
+#endif
+
+/**
+ * @desc    Stream pixel after RAMWR, pairs packed in 12 bits mode
+ *
+ * @param   uint16_t color
+ * @return  void
+ */
+void SendPixel(uint16_t color)
+{
+  PERF_INC(pixels);
+#if ST7735_COLOR_BITS == 12
+  // first of pair waits
+  if (!pixelPending) {
+    pixel = color;
+    pixelPending = 1;
+    return;
+  }
+  pixelPending = 0;
+  PIXEL_SELECT();
+  // pair in 3 bytes
+  PIXEL_BYTE(pixel >> 4);
+  PIXEL_BYTE((uint8_t) (pixel << 4) | (color >> 8));
+  PIXEL_BYTE((uint8_t) color);
+#else
+  PIXEL_SELECT();
+  // pixel in 2 bytes
+  PIXEL_BYTE((uint8_t) (color >> 8));
+  PIXEL_BYTE((uint8_t) color);
+#endif
+}
+
+/**
+ * @desc    Wait till SPI queue is sent - nothing queued in blocking mode
+ *
+ * @param   void
+ * @return  void
+ */
+void St7735Flush(void)
+{
+}
+
+#endif
+
+/**
+ * @desc    End of pixel stream - sends unpaired pixel
+ *
+ * @param   void
+ * @return  void
+ */
+void SendPixelEnd(void)
+{
+#if ST7735_COLOR_BITS == 12
+  // check if pixel waits for pair
+  if (pixelPending) {
+    pixelPending = 0;
+    PIXEL_SELECT();
+    // controller ignores unpaired nibble
+    PIXEL_BYTE(pixel >> 4);
+    PIXEL_BYTE((uint8_t) (pixel << 4));
+  }
+#endif
+  // burst done - chip disable
+  PIXEL_RELEASE();
+}
+
+/** @var Glyph colors - background, foreground */
+static uint16_t glyphColors[2];
+#if ST7735_COLOR_BITS == 12
+/** @array Pixel pairs of glyph colors in 3 bytes, index by 2 bits */
+static uint8_t glyphPairs[4][3];
+#endif
+
+/**
+ * @desc    Set colors of glyph rows, 12 bits mode fills pixel pair table
+ *
+ * @param   uint16_t  color
+ * @param   uint16_t  background
+ * @return  void
+ */
+static void GlyphColors(uint16_t color, uint16_t background)
+{
+#if ST7735_COLOR_BITS == 12
+  uint8_t i;
+  uint16_t first, second;
+#endif
+
+  // bit clear - background, bit set - color
+  glyphColors[0] = background;
+  glyphColors[1] = color;
+#if ST7735_COLOR_BITS == 12
+  // pairs 00, 01, 10, 11
+  for (i = 0; i < 4; i++) {
+    first = glyphColors[i >> 1];
+    second = glyphColors[i & 1];
+    glyphPairs[i][0] = (uint8_t) (first >> 4);
+    glyphPairs[i][1] = (uint8_t) ((first << 4) | ((second >> 8) & 0x0F));
+    glyphPairs[i][2] = (uint8_t) second;
+  }
+#endif
+}
+
+/**
+ * @desc    Stream pixels of glyph row, most significant bit first
+ *
+ * @param   uint8_t   row bits
+ * @param   uint8_t   number of pixels
+ * @return  void
+ */
+static void SendGlyphRow(uint8_t bits, uint8_t count)
+{
+  // pixel pairs
+  for (; count > 1; count -= 2) {
+#if ST7735_COLOR_BITS == 12
+    // pair bytes from table if stream is on pair boundary
+    if (!pixelPending) {
+      PERF_ADD(pixels, 2);
+      PIXEL_SELECT();
+      PIXEL_BYTE(glyphPairs[bits >> 6][0]);
+      PIXEL_BYTE(glyphPairs[bits >> 6][1]);
+      PIXEL_BYTE(glyphPairs[bits >> 6][2]);
+    } else {
+      SendPixel(glyphColors[bits >> 7]);
+      SendPixel(glyphColors[(bits >> 6) & 1]);
+    }
+#else
+    SendPixel(glyphColors[bits >> 7]);
+    SendPixel(glyphColors[(bits >> 6) & 1]);
+#endif
+    bits <<= 2;
+  }
+  // odd pixel
+  if (count) {
+    SendPixel(glyphColors[bits >> 7]);
+  }
+}
+
 /**
  * @desc    Set Partial Area / Window
  *
@@ -401,6 +1148,7 @@ uint8_t SetWindow(uint8_t x0, uint8_t x1, uint8_t y0, uint8_t y1)
     // out of range
     return ST7735_ERROR;
   }  
+  PERF_INC(windows);
   // column address set
   CommandSend(CASET);
   // send start x position
@@ -411,31 +1159,12 @@ uint8_t SetWindow(uint8_t x0, uint8_t x1, uint8_t y0, uint8_t y1)
   // row address set
   CommandSend(RASET);
   // send start y position
-  Data16BitsSend(0x0000 | y0);
-  // send end y position
-  Data16BitsSend(0x0000 | y1);
-
-  // success
-  return ST7735_SUCCESS;
-}
-
-/**
- * @desc    Write color pixels
- *
- * @param   uint16_t color
- * @param   uint16_t counter
- *
- * @return  void
- */
-void SendColor565(uint16_t color, uint16_t count)
-{
-  // access to RAM
-  CommandSend(RAMWR);
-  // counter
-  while (count--) {
-    // write color
-    Data16BitsSend(color);
-  }
+  Data16BitsSend(0x0000 | y0);
+  // send end y position
+  Data16BitsSend(0x0000 | y1);
+
+  // success
+  return ST7735_SUCCESS;
 }
 
 /**
@@ -467,8 +1196,8 @@ char DrawChar(char character, uint16_t color, ESizes size)
   // variables
   uint8_t letter, idxCol, idxRow;
   // check if character is out of range
-  if ((character < 0x20) &&
-      (character > 0x7f)) { 
+  if (((unsigned char) character < 0x20) ||
+      ((unsigned char) character > 0x7F)) {
     // out of range
     return 0;
   }
@@ -636,6 +1365,120 @@ void DrawString(volatile const char *str, uint16_t color, ESizes size)
   }
 }
 
+/**
+ * @desc    Stream characters of one line in one window - every pixel
+ *          of cells written, no clear before draw
+ *
+ * @param   const char* characters
+ * @param   uint8_t   number of characters
+ * @param   uint16_t  color
+ * @param   uint16_t  background
+ * @param   Esizes    see enum sizes in st7735.h
+ * @return  char
+ */
+static char StreamText(const char *str, uint8_t len, uint16_t color, uint16_t background, ESizes size)
+{
+  uint8_t wide = size & 0x0F;
+  uint8_t high = size >> 4;
+  uint8_t row, i, bit, bits;
+
+  // window of cells
+  if (ST7735_SUCCESS != SetWindow(cacheMemIndexCol,
+                                  cacheMemIndexCol + len * (CHARS_COLS_LEN + 1) * wide - 1,
+                                  cacheMemIndexRow,
+                                  cacheMemIndexRow + CHARS_ROWS_LEN * high - 1)) {
+    // out of range
+    return ST7735_ERROR;
+  }
+  // access to RAM
+  CommandSend(RAMWR);
+  // glyph colors
+  GlyphColors(color, background);
+  // rows of window, tall font repeats glyph rows
+  for (row = 0; row < CHARS_ROWS_LEN * high; row++) {
+    for (i = 0; i < len; i++) {
+      // glyph row, unknown characters blank
+      bits = 0;
+      if (((unsigned char) str[i] >= 0x20) && ((unsigned char) str[i] <= 0x7F)) {
+        bits = pgm_read_byte(&CHARACTERS_ROWS[str[i] - 32][row / high]);
+      }
+      // normal width
+      if (wide == 1) {
+        SendGlyphRow(bits, CHARS_COLS_LEN + 1);
+      // wide - every pixel twice
+      } else {
+        for (bit = 0; bit < CHARS_COLS_LEN + 1; bit++) {
+          SendGlyphRow((bits & 0x80) ? 0xC0 : 0x00, wide);
+          bits <<= 1;
+        }
+      }
+    }
+  }
+  // unpaired pixel
+  SendPixelEnd();
+  // success
+  return ST7735_SUCCESS;
+}
+
+/**
+ * @desc    Draw character with background - one window
+ *
+ * @param   char      character
+ * @param   uint16_t  color
+ * @param   uint16_t  background
+ * @param   Esizes    see enum sizes in st7735.h
+ * @return  char
+ */
+char DrawCharOpaque(char character, uint16_t color, uint16_t background, ESizes size)
+{
+  // one cell
+  return StreamText(&character, 1, color, background, size);
+}
+
+/**
+ * @desc    Draw string with background - one window per line
+ *
+ * @param   char*     string
+ * @param   uint16_t  color
+ * @param   uint16_t  background
+ * @param   Esizes    see enum sizes in st7735.h
+ * @return  void
+ */
+void DrawStringOpaque(const char *str, uint16_t color, uint16_t background, ESizes size)
+{
+  // width of cell
+  uint8_t cell = (CHARS_COLS_LEN + 1) * (size & 0x0F);
+  uint8_t len;
+
+  // loop through lines
+  while (*str != '\0') {
+    // characters fitting to line
+    len = 0;
+    while ((str[len] != '\0') && ((cacheMemIndexCol + (len + 1) * cell) <= MAX_X)) {
+      len++;
+    }
+    // next line
+    if (len == 0) {
+      // check if first column too
+      if (cacheMemIndexCol == 2) {
+        return;
+      }
+      // set position y
+      cacheMemIndexRow = cacheMemIndexRow + (CHARS_ROWS_LEN + 1) * (size >> 4) + 2;
+      // set position x
+      cacheMemIndexCol = 2;
+      continue;
+    }
+    // line of characters
+    if (ST7735_SUCCESS != StreamText(str, len, color, background, size)) {
+      return;
+    }
+    // update position
+    cacheMemIndexCol += len * cell;
+    str += len;
+  }
+}
+
 /**
  * @desc    Draw line by Bresenham algoritm
  * @surce   https://en.wikipedia.org/wiki/Bresenham%27s_line_algorithm
@@ -741,7 +1584,7 @@ void DrawLineHorizontal(uint8_t xs, uint8_t xe, uint8_t y, uint16_t color)
   // check if start is > as end  
   if (xs > xe) {
     // temporary safe
-    temp = xs;
+    temp = xe;
     // start change for end
     xe = xs;
     // end change for start
@@ -750,7 +1593,7 @@ void DrawLineHorizontal(uint8_t xs, uint8_t xe, uint8_t y, uint16_t color)
   // set window
   SetWindow(xs, xe, y, y);
   // draw pixel by 565 mode
-  SendColor565(color, xe - xs);
+  SendColor565(color, xe - xs + 1);
 }
 
 /**
@@ -768,7 +1611,7 @@ void DrawLineVertical(uint8_t x, uint8_t ys, uint8_t ye, uint16_t color)
   // check if start is > as end
   if (ys > ye) {
     // temporary safe
-    temp = ys;
+    temp = ye;
     // start change for end
     ye = ys;
     // end change for start
@@ -777,7 +1620,7 @@ void DrawLineVertical(uint8_t x, uint8_t ys, uint8_t ye, uint16_t color)
   // set window
   SetWindow(x, x, ys, ye);
   // draw pixel by 565 mode
-  SendColor565(color, ye - ys);
+  SendColor565(color, ye - ys + 1);
 }
 
 /**
@@ -817,6 +1660,548 @@ void DrawRectangle(uint8_t xs, uint8_t xe, uint8_t ys, uint8_t ye, uint16_t colo
   SendColor565(color, (xe-xs+1)*(ye-ys+1));  
 }
 
+/**
+ * @desc    Fill area clipped to screen - one window, one color run
+ *
+ * @param   int16_t   x start position
+ * @param   int16_t   x end position
+ * @param   int16_t   y start position
+ * @param   int16_t   y end position
+ * @param   uint16_t  color
+ * @return  void
+ */
+static void FillArea(int16_t xs, int16_t xe, int16_t ys, int16_t ye, uint16_t color)
+{
+  int16_t temp;
+  // check if start is > as end
+  if (xs > xe) {
+    // swap x
+    temp = xe; xe = xs; xs = temp;
+  }
+  // check if start is > as end
+  if (ys > ye) {
+    // swap y
+    temp = ye; ye = ys; ys = temp;
+  }
+  // check if area is out of screen
+  if ((xe < 0) || (xs > SIZE_X) || (ye < 0) || (ys > SIZE_Y)) {
+    // nothing to draw
+    return;
+  }
+  // clip to screen
+  if (xs < 0) { xs = 0; }
+  if (ys < 0) { ys = 0; }
+  if (xe > SIZE_X) { xe = SIZE_X; }
+  if (ye > SIZE_Y) { ye = SIZE_Y; }
+  // set window
+  SetWindow(xs, xe, ys, ye);
+  // send color
+  SendColor565(color, (xe - xs + 1) * (ye - ys + 1));
+}
+
+/**
+ * @desc    Draw segment by Bresenham algorithm as runs
+ *          horizontal runs for m < 1, vertical runs for m >= 1
+ *
+ * @param   int16_t   x start position
+ * @param   int16_t   y start position
+ * @param   int16_t   x end position
+ * @param   int16_t   y end position
+ * @param   uint16_t  color
+ * @return  void
+ */
+static void DrawSegment(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+  int16_t delta_x = x1 - x0;
+  int16_t delta_y = y1 - y0;
+  int16_t trace_x = 1, trace_y = 1;
+  int16_t error, start;
+
+  // check if x1 > x0
+  if (delta_x < 0) {
+    // negate delta x and step x
+    delta_x = -delta_x;
+    trace_x = -trace_x;
+  }
+  // check if y1 > y0
+  if (delta_y < 0) {
+    // negate delta y and step y
+    delta_y = -delta_y;
+    trace_y = -trace_y;
+  }
+
+  // m < 1 - horizontal runs
+  if (delta_y <= delta_x) {
+    error = delta_x >> 1;
+    start = x0;
+    while (x0 != x1) {
+      error -= delta_y;
+      // step in y closes the run
+      if (error < 0) {
+        FillArea(start, x0, y0, y0, color);
+        y0 += trace_y;
+        error += delta_x;
+        start = x0 + trace_x;
+      }
+      x0 += trace_x;
+    }
+    // last run
+    FillArea(start, x0, y0, y0, color);
+  // m >= 1 - vertical runs
+  } else {
+    error = delta_y >> 1;
+    start = y0;
+    while (y0 != y1) {
+      error -= delta_x;
+      // step in x closes the run
+      if (error < 0) {
+        FillArea(x0, x0, start, y0, color);
+        x0 += trace_x;
+        error += delta_y;
+        start = y0 + trace_y;
+      }
+      y0 += trace_y;
+    }
+    // last run
+    FillArea(x0, x0, start, y0, color);
+  }
+}
+
+/**
+ * @desc    Corner run of midpoint circle mirrored to all octants
+ *          left corners at x0, right corners at x1,
+ *          top corners at y0, bottom corners at y1
+ *
+ * @param   int16_t   x left corner
+ * @param   int16_t   x right corner
+ * @param   int16_t   y top corner
+ * @param   int16_t   y bottom corner
+ * @param   int16_t   run start offset
+ * @param   int16_t   run end offset
+ * @param   int16_t   run distance from center
+ * @param   uint8_t   fill
+ * @param   uint16_t  color
+ * @return  void
+ */
+static void DrawCornerRun(int16_t x0, int16_t x1, int16_t y0, int16_t y1,
+                          int16_t rs, int16_t re, int16_t d, uint8_t fill, uint16_t color)
+{
+  // fill - one span across row, center row filled by caller
+  if (fill) {
+    if (d > 0) {
+      FillArea(x0 - re, x1 + re, y0 - d, y0 - d, color);
+      FillArea(x0 - re, x1 + re, y1 + d, y1 + d, color);
+    }
+    return;
+  }
+  // top and bottom octants - horizontal runs
+  FillArea(x0 - re, x0 - rs, y0 - d, y0 - d, color);
+  FillArea(x1 + rs, x1 + re, y0 - d, y0 - d, color);
+  FillArea(x0 - re, x0 - rs, y1 + d, y1 + d, color);
+  FillArea(x1 + rs, x1 + re, y1 + d, y1 + d, color);
+  // left and right octants - vertical runs
+  FillArea(x0 - d, x0 - d, y0 - re, y0 - rs, color);
+  FillArea(x1 + d, x1 + d, y0 - re, y0 - rs, color);
+  FillArea(x0 - d, x0 - d, y1 + rs, y1 + re, color);
+  FillArea(x1 + d, x1 + d, y1 + rs, y1 + re, color);
+}
+
+/**
+ * @desc    Draw corners by midpoint circle algorithm
+ * @surce   https://en.wikipedia.org/wiki/Midpoint_circle_algorithm
+ *          circle is x0 = x1, y0 = y1; rounded rectangle has corners
+ *          centers inset by radius
+ *
+ * @param   int16_t   x left corner
+ * @param   int16_t   x right corner
+ * @param   int16_t   y top corner
+ * @param   int16_t   y bottom corner
+ * @param   uint8_t   radius
+ * @param   uint8_t   fill
+ * @param   uint16_t  color
+ * @return  void
+ */
+static void DrawCorners(int16_t x0, int16_t x1, int16_t y0, int16_t y1,
+                        uint8_t r, uint8_t fill, uint16_t color)
+{
+  // offsets
+  int16_t x = 0, y = r;
+  // determinant
+  int16_t D = 1 - r;
+  // start of run
+  int16_t start = 0;
+
+  // center rows
+  if (fill) {
+    FillArea(x0 - r, x1 + r, y0, y1, color);
+  }
+  // walk one octant
+  while (x <= y) {
+    // fill - rows of second octant, one per x
+    if (fill && x) {
+      FillArea(x0 - y, x1 + y, y0 - x, y0 - x, color);
+      FillArea(x0 - y, x1 + y, y1 + x, y1 + x, color);
+    }
+    // check if determinant is negative
+    if (D < 0) {
+      // update deteminant
+      D += (x << 1) + 3;
+    } else {
+      // step in y closes the run
+      DrawCornerRun(x0, x1, y0, y1, start, x, y, fill, color);
+      // update determinant
+      D += ((x - y) << 1) + 5;
+      // update y
+      y--;
+      // next run
+      start = x + 1;
+    }
+    // update x
+    x++;
+  }
+  // last run
+  if (start < x) {
+    DrawCornerRun(x0, x1, y0, y1, start, x - 1, y, fill, color);
+  }
+}
+
+/**
+ * @desc    Draw circle
+ *
+ * @param   uint8_t   x center position
+ * @param   uint8_t   y center position
+ * @param   uint8_t   radius
+ * @param   uint16_t  color
+ * @return  void
+ */
+void DrawCircle(uint8_t x, uint8_t y, uint8_t r, uint16_t color)
+{
+  // outline corners around one center
+  DrawCorners(x, x, y, y, r, 0, color);
+}
+
+/**
+ * @desc    Fill circle
+ *
+ * @param   uint8_t   x center position
+ * @param   uint8_t   y center position
+ * @param   uint8_t   radius
+ * @param   uint16_t  color
+ * @return  void
+ */
+void FillCircle(uint8_t x, uint8_t y, uint8_t r, uint16_t color)
+{
+  // filled corners around one center
+  DrawCorners(x, x, y, y, r, 1, color);
+}
+
+/**
+ * @desc    Limit radius to half of shorter side
+ *
+ * @param   uint8_t   width - 1
+ * @param   uint8_t   height - 1
+ * @param   uint8_t   radius
+ * @return  uint8_t
+ */
+static uint8_t LimitRadius(uint8_t w, uint8_t h, uint8_t r)
+{
+  // shorter side
+  uint8_t side = (w < h) ? w : h;
+  // radius fits in half
+  return (r > (side >> 1)) ? (side >> 1) : r;
+}
+
+/**
+ * @desc    Draw rounded rectangle
+ *
+ * @param   uint8_t   x start position
+ * @param   uint8_t   x end position
+ * @param   uint8_t   y start position
+ * @param   uint8_t   y end position
+ * @param   uint8_t   corner radius
+ * @param   uint16_t  color
+ * @return  void
+ */
+void DrawRoundRectangle(uint8_t xs, uint8_t xe, uint8_t ys, uint8_t ye, uint8_t r, uint16_t color)
+{
+  uint8_t temp;
+  // check if start is > as end
+  if (xs > xe) { temp = xe; xe = xs; xs = temp; }
+  // check if start is > as end
+  if (ys > ye) { temp = ye; ye = ys; ys = temp; }
+  // limit radius
+  r = LimitRadius(xe - xs, ye - ys, r);
+  // top and bottom edge
+  FillArea(xs + r, xe - r, ys, ys, color);
+  FillArea(xs + r, xe - r, ye, ye, color);
+  // left and right edge
+  FillArea(xs, xs, ys + r, ye - r, color);
+  FillArea(xe, xe, ys + r, ye - r, color);
+  // corners
+  DrawCorners(xs + r, xe - r, ys + r, ye - r, r, 0, color);
+}
+
+/**
+ * @desc    Fill rounded rectangle
+ *
+ * @param   uint8_t   x start position
+ * @param   uint8_t   x end position
+ * @param   uint8_t   y start position
+ * @param   uint8_t   y end position
+ * @param   uint8_t   corner radius
+ * @param   uint16_t  color
+ * @return  void
+ */
+void FillRoundRectangle(uint8_t xs, uint8_t xe, uint8_t ys, uint8_t ye, uint8_t r, uint16_t color)
+{
+  uint8_t temp;
+  // check if start is > as end
+  if (xs > xe) { temp = xe; xe = xs; xs = temp; }
+  // check if start is > as end
+  if (ys > ye) { temp = ye; ye = ys; ys = temp; }
+  // limit radius
+  r = LimitRadius(xe - xs, ye - ys, r);
+  // filled corners with center block
+  DrawCorners(xs + r, xe - r, ys + r, ye - r, r, 1, color);
+}
+
+/**
+ * @desc    Draw triangle
+ *
+ * @param   uint8_t   x first vertex
+ * @param   uint8_t   y first vertex
+ * @param   uint8_t   x second vertex
+ * @param   uint8_t   y second vertex
+ * @param   uint8_t   x third vertex
+ * @param   uint8_t   y third vertex
+ * @param   uint16_t  color
+ * @return  void
+ */
+void DrawTriangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t x3, uint8_t y3, uint16_t color)
+{
+  // edges as runs
+  DrawSegment(x1, y1, x2, y2, color);
+  DrawSegment(x2, y2, x3, y3, color);
+  DrawSegment(x3, y3, x1, y1, color);
+}
+
+/**
+ * @desc    Fill triangle by scanlines
+ *
+ * @param   uint8_t   x first vertex
+ * @param   uint8_t   y first vertex
+ * @param   uint8_t   x second vertex
+ * @param   uint8_t   y second vertex
+ * @param   uint8_t   x third vertex
+ * @param   uint8_t   y third vertex
+ * @param   uint16_t  color
+ * @return  void
+ */
+void FillTriangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t x3, uint8_t y3, uint16_t color)
+{
+  // sorted vertices y0 <= ym <= ye
+  int16_t x0 = x1, y0 = y1, xm = x2, ym = y2, xl = x3, yl = y3;
+  // edge deltas
+  int16_t dx0m, dy0m, dx0l, dy0l, dxml, dyml;
+  // edge accumulators
+  int16_t sa = 0, sb = 0;
+  // scanline
+  int16_t y, last, temp;
+
+  // sort by y
+  if (y0 > ym) { temp = y0; y0 = ym; ym = temp; temp = x0; x0 = xm; xm = temp; }
+  if (ym > yl) { temp = ym; ym = yl; yl = temp; temp = xm; xm = xl; xl = temp; }
+  if (y0 > ym) { temp = y0; y0 = ym; ym = temp; temp = x0; x0 = xm; xm = temp; }
+
+  // degenerated - all vertices in one row
+  if (y0 == yl) {
+    // min and max x
+    temp = x0;
+    if (xm < temp) { temp = xm; }
+    if (xl < temp) { temp = xl; }
+    if (xm > x0) { x0 = xm; }
+    if (xl > x0) { x0 = xl; }
+    // one span
+    FillArea(temp, x0, y0, y0, color);
+    return;
+  }
+
+  dx0m = xm - x0; dy0m = ym - y0;
+  dx0l = xl - x0; dy0l = yl - y0;
+  dxml = xl - xm; dyml = yl - ym;
+
+  // upper part - edges 0-m and 0-l, row ym included
+  // only if lower part is flat
+  last = (ym == yl) ? ym : ym - 1;
+  for (y = y0; y <= last; y++) {
+    FillArea(x0 + sa / dy0m, x0 + sb / dy0l, y, y, color);
+    sa += dx0m;
+    sb += dx0l;
+  }
+  // lower part - edges m-l and 0-l
+  sa = dxml * (y - ym);
+  sb = dx0l * (y - y0);
+  for (; y <= yl; y++) {
+    FillArea(xm + sa / dyml, x0 + sb / dy0l, y, y, color);
+    sa += dxml;
+    sb += dx0l;
+  }
+}
+
+/**
+ * @desc    Set vertical scroll area
+ *
+ * @param   uint8_t top fixed area
+ * @param   uint8_t height of scroll area
+ * @return  uint8_t
+ */
+uint8_t SetScrollArea(uint8_t top, uint8_t height)
+{
+  // check if area is out of range
+  if ((top + height) > SCROLL_LINES) {
+    // out of range
+    return ST7735_ERROR;
+  }
+  // vertical scroll definition
+  CommandSend(VSCRDEF);
+  // top fixed area
+  Data16BitsSend(top);
+  // vertical scroll area
+  Data16BitsSend(height);
+  // bottom fixed area
+  Data16BitsSend(SCROLL_LINES - top - height);
+  // success
+  return ST7735_SUCCESS;
+}
+
+/**
+ * @desc    Set vertical scroll start address
+ *
+ * @param   uint8_t memory row
+ * @return  void
+ */
+void SetScrollStart(uint8_t line)
+{
+  // vertical scroll start address
+  CommandSend(VSCSAD);
+  // start line
+  Data16BitsSend(line);
+}
+
+/** @var Console top of scroll area */
+static uint8_t consoleTop;
+/** @var Console bottom of scroll area */
+static uint8_t consoleEnd;
+/** @var Console memory row of oldest line */
+static uint8_t consoleLine;
+/** @var Console colors */
+static uint16_t consoleColor;
+static uint16_t consoleBackground;
+
+/**
+ * @desc    Init scrolling console
+ *
+ * @param   uint8_t   top fixed area
+ * @param   uint8_t   number of lines
+ * @param   uint16_t  text color
+ * @param   uint16_t  background color
+ * @return  char
+ */
+char ConsoleInit(uint8_t top, uint8_t lines, uint16_t color, uint16_t background)
+{
+  // scroll area height - 16 bits, many lines overflow 8 bits
+  uint16_t height = (uint16_t) lines * CONSOLE_LINE_HEIGHT;
+
+  // at least one line, area in memory rows
+  if (!lines || ((top + height) > SCROLL_LINES)) {
+    // out of range
+    return ST7735_ERROR;
+  }
+  // scroll area definition
+  if (ST7735_SUCCESS != SetScrollArea(top, height)) {
+    // out of range
+    return ST7735_ERROR;
+  }
+  // rows follow memory rows
+  SetRotation(CONSOLE_ROTATION);
+  // store console area
+  consoleTop = top;
+  consoleEnd = top + height;
+  consoleLine = top;
+  consoleColor = color;
+  consoleBackground = background;
+  // scroll start on top
+  SetScrollStart(consoleTop);
+  // clear scroll area
+  CommandSend(CASET);
+  Data16BitsSend(0);
+  Data16BitsSend(SCROLL_COLS - 1);
+  CommandSend(RASET);
+  Data16BitsSend(consoleTop);
+  Data16BitsSend(consoleEnd - 1);
+  SendColor565(background, SCROLL_COLS * height);
+  // success
+  return ST7735_SUCCESS;
+}
+
+/**
+ * @desc    Append line to console
+ *          oldest line is overwritten and scroll start moves
+ *          one line down - only pixels of new line are sent
+ *
+ * @param   char*   string
+ * @return  void
+ */
+void ConsolePrint(const char *str)
+{
+  uint8_t row, col, bits, letter, len = 0;
+
+  // length limited to one line
+  while ((len < CONSOLE_LINE_CHARS) && (str[len] != '\0')) {
+    len++;
+  }
+  // line window in memory rows
+  CommandSend(CASET);
+  Data16BitsSend(0);
+  Data16BitsSend(SCROLL_COLS - 1);
+  CommandSend(RASET);
+  Data16BitsSend(consoleLine);
+  Data16BitsSend(consoleLine + CONSOLE_LINE_HEIGHT - 1);
+  // access to RAM
+  CommandSend(RAMWR);
+  // glyph colors
+  GlyphColors(consoleColor, consoleBackground);
+  // stream rows of glyphs - one row byte per character
+  for (row = 0; row < CONSOLE_LINE_HEIGHT; row++) {
+    for (letter = 0; letter < CONSOLE_LINE_CHARS; letter++) {
+      // glyph row or background
+      bits = 0;
+      if ((row < CHARS_ROWS_LEN) &&
+          (letter < len) &&
+          ((unsigned char) str[letter] >= 0x20) &&
+          ((unsigned char) str[letter] <= 0x7F)) {
+        bits = pgm_read_byte(&CHARACTERS_ROWS[str[letter] - 32][row]);
+      }
+      // character and gap column
+      SendGlyphRow(bits, CHARS_COLS_LEN + 1);
+    }
+    // rest of line
+    for (col = CONSOLE_LINE_CHARS * (CHARS_COLS_LEN + 1); col < SCROLL_COLS; col++) {
+      SendPixel(consoleBackground);
+    }
+  }
+  // unpaired pixel
+  SendPixelEnd();
+  // next oldest line
+  consoleLine += CONSOLE_LINE_HEIGHT;
+  // wrap in scroll area
+  if (consoleLine >= consoleEnd) {
+    consoleLine = consoleTop;
+  }
+  // newest line at bottom of scroll area
+  SetScrollStart(consoleLine);
+}
+
 /**
  * @desc    Clear screen
  *
@@ -851,9 +2236,6 @@ void UpdateScreen(void)
  */
 void DelayMs(uint8_t time)
 {
-  // loop through real time
-  while (time--) {
-    // 1 s delay
-    _delay_ms(1);
-  }
+  // core sleeps on timer, busy wait before scheduler init
+  SchedDelay(time);
 }
@@ -13,7 +13,11 @@
  *              http://w8bh.net/avr/AvrTFT.pdf
  *
  */
-#include <avr/pgmspace.h>
+#if defined(__AVR__)
+  #include <avr/pgmspace.h>
+#else
+  #include "hostlcd.h"
+#endif
 
 #ifndef __ST7735_H__
 #define __ST7735_H__
@@ -46,6 +50,23 @@
     #define ST7735_SCK    7
   #endif
 
+  // ST7735_ASYNC - SPI output queued and sent by SPI transfer complete
+  // interrupt, polled while interrupts are disabled
+  // SPI clock fosc / ST7735_SPI_DIV - 2, 4, 8, 16, 32, 64 or 128, byte
+  // takes 8 * ST7735_SPI_DIV cycles; interrupt per byte costs ~90 cycles,
+  // so queued output needs slower clock than polling to free the CPU
+  #ifndef ST7735_SPI_DIV
+    #ifdef ST7735_ASYNC
+      #define ST7735_SPI_DIV 32
+    #else
+      #define ST7735_SPI_DIV 2
+    #endif
+  #endif
+  #ifndef ST7735_QUEUE_SIZE
+    // queue entries, power of 2
+    #define ST7735_QUEUE_SIZE 16
+  #endif
+
   #ifndef HW_RESET_DDR
     #define HW_RESET_DDR  DDRB
   #endif
@@ -78,7 +99,9 @@
   #define RAMWR   0x2C
 
   #define PTLAR   0x30
+  #define VSCRDEF 0x33
   #define MADCTL  0x36
+  #define VSCSAD  0x37
   #define COLMOD  0x3A
 
   #define FRMCTR1 0xB1
@@ -104,19 +127,118 @@
 
   #define PWCTR6  0xFC
 
+  // number of arguments per command - checked by init list builder
+  #define NOP_ARGS     0
+  #define SWRESET_ARGS 0
+  #define SLPIN_ARGS   0
+  #define SLPOUT_ARGS  0
+  #define PTLON_ARGS   0
+  #define NORON_ARGS   0
+  #define INVOFF_ARGS  0
+  #define INVON_ARGS   0
+  #define DISPOFF_ARGS 0
+  #define DISPON_ARGS  0
+  #define CASET_ARGS   4
+  #define RASET_ARGS   4
+  #define PTLAR_ARGS   4
+  #define VSCRDEF_ARGS 6
+  #define MADCTL_ARGS  1
+  #define VSCSAD_ARGS  2
+  #define COLMOD_ARGS  1
+  #define FRMCTR1_ARGS 3
+  #define FRMCTR2_ARGS 3
+  #define FRMCTR3_ARGS 6
+  #define INVCTR_ARGS  1
+  #define DISSET5_ARGS 2
+  #define PWCTR2_ARGS  1
+  #define PWCTR3_ARGS  2
+  #define PWCTR4_ARGS  2
+  #define PWCTR5_ARGS  2
+  #define GMCTRP1_ARGS 16
+  #define GMCTRN1_ARGS 16
+  #define PWCTR6_ARGS  2
+
+  // controller variants - ST7735S modules take ST7735R list
+  #define ST7735_B 0
+  #define ST7735_R 1
+  #ifndef ST7735_VARIANT
+    #define ST7735_VARIANT ST7735_B
+  #endif
+  // ST7735B and ST7735R differ in power control arguments
+  #if ST7735_VARIANT == ST7735_R
+    #define PWCTR1_ARGS  3
+    #define VMCTR1_ARGS  1
+  #else
+    #define PWCTR1_ARGS  2
+    #define VMCTR1_ARGS  2
+  #endif
+  // memory access control set by init list - 0xA0 landscape
+  #ifndef ST7735_MADCTL
+    #define ST7735_MADCTL 0xA0
+  #endif
+  // rotations follow ST7735_MADCTL - MY, MX, MV with odd number of bits
+  // set are mirrored cycle (plain one with MY toggled)
+  #define ST7735_MIRROR   ((((ST7735_MADCTL >> 7) ^ (ST7735_MADCTL >> 6) ^ (ST7735_MADCTL >> 5)) & 1) << 7)
+  // index of MY, MX, MV in plain cycle 0xA0, 0x00, 0x60, 0xC0
+  #define ST7735_CYCLE(madctl) \
+    (((((madctl) & 0xE0) ^ ST7735_MIRROR) == 0xA0) ? 0 : \
+     ((((madctl) & 0xE0) ^ ST7735_MIRROR) == 0x00) ? 1 : \
+     ((((madctl) & 0xE0) ^ ST7735_MIRROR) == 0x60) ? 2 : 3)
+  // ROTATE_0 is init list value
+  #define ST7735_ROTATION ST7735_CYCLE(ST7735_MADCTL)
+
+  // Init list builder - entries of list in PROGMEM:
+  //  number of commands, then per command
+  //  command, number of arguments | DELAY, arguments, [delay ms]
+  //  argument count is checked against <command>_ARGS, delay byte only
+  //  if set; a wrong count or delay over 255 ms fails compilation
+  #define ST7735_ARGS(...)              (sizeof((const uint8_t[]) { 0, ##__VA_ARGS__ }) - 1)
+  #define ST7735_CHECK(args, ...)       (0 * sizeof(char[(ST7735_ARGS(__VA_ARGS__) == (args)) ? 1 : -1]))
+  #define ST7735_CMD(cmd, ...)          cmd, ST7735_ARGS(__VA_ARGS__) + ST7735_CHECK(cmd##_ARGS, ##__VA_ARGS__), ##__VA_ARGS__,
+  #define ST7735_CMD_DELAY(ms, cmd, ...) cmd, (ST7735_ARGS(__VA_ARGS__) | DELAY) + ST7735_CHECK(cmd##_ARGS, ##__VA_ARGS__), ##__VA_ARGS__, \
+                                        (ms) + 0 * sizeof(char[((ms) > 0) && ((ms) < 256) ? 1 : -1]),
+  #define ST7735_COUNT(...)             + 1
+  #define ST7735_COUNT_DELAY(...)       + 1
+  // list to PROGMEM bytes
+  #define ST7735_INIT_LIST(LIST)        (0 LIST(ST7735_COUNT, ST7735_COUNT_DELAY)), LIST(ST7735_CMD, ST7735_CMD_DELAY)
+
+  // Color depth - 16 bits RGB565 (default) or 12 bits RGB444,
+  // 12 bits mode sends 2 pixels in 3 bytes
+  #ifndef ST7735_COLOR_BITS
+    #define ST7735_COLOR_BITS 16
+  #endif
+  #if ST7735_COLOR_BITS == 12
+    // interface pixel format 12 bits
+    #define ST7735_COLMOD 0x03
+    // RGB565 constant to RGB444 at compile time
+    #define ST7735_COLOR(c) ((((c) >> 4) & 0x0F00) | (((c) >> 3) & 0x00F0) | (((c) >> 1) & 0x000F))
+  #else
+    // interface pixel format 16 bits
+    #define ST7735_COLMOD 0x05
+    // RGB565 native
+    #define ST7735_COLOR(c) (c)
+  #endif
+  // 8 bits components to color of selected depth
+  #define ST7735_RGB(r, g, b) ST7735_COLOR((((r) & 0xF8) << 8) | (((g) & 0xFC) << 3) | ((b) >> 3))
+
   // Colors
-  #define BLACK   0x0000
-  #define WHITE   0xFFFF
-  #define RED     0xF000
+  #define BLACK   ST7735_COLOR(0x0000)
+  #define WHITE   ST7735_COLOR(0xFFFF)
+  #define RED     ST7735_COLOR(0xF000)
 
   #define ST7735_SUCCESS 0
   #define ST7735_ERROR   1
 
-  // MV = 0 in MADCTL
-  // max columns
-  #define MAX_X   162
-  // max rows
-  #define MAX_Y   132
+  // St7735InitStep finished
+  #define ST7735_INIT_DONE 0xFFFF
+
+  // display memory - 132 columns x 162 rows (MV = 0 in MADCTL)
+  #define ST7735_COLS 132
+  #define ST7735_ROWS 162
+  // max columns of current rotation
+  #define MAX_X   st7735Width
+  // max rows of current rotation
+  #define MAX_Y   st7735Height
   // columns max counter
   #define SIZE_X  MAX_X - 1
   // rows max counter
@@ -128,12 +250,32 @@
   // number of rows for chars
   #define CHARS_ROWS_LEN 8
 
-  /** @const Command list ST7735B */
-  extern const uint8_t INIT_ST7735B[];
-
-  /** @const Characters */
+  // Vertical scrolling runs along the 162 memory rows (MV = 0)
+  // memory rows
+  #define SCROLL_LINES   ST7735_ROWS
+  // memory columns
+  #define SCROLL_COLS    ST7735_COLS
+  // rotation of console - portrait, rows follow memory rows (MY, MV
+  // clear - 0x00, mirrored panel 0x40)
+  #define CONSOLE_ROTATION ((ERotation) ((ST7735_CYCLE(ST7735_MIRROR ? 0xC0 : 0x00) - ST7735_ROTATION) & 0x03))
+  // console line height
+  #define CONSOLE_LINE_HEIGHT (CHARS_ROWS_LEN + 2)
+  // console characters per line
+  #define CONSOLE_LINE_CHARS  (SCROLL_COLS / (CHARS_COLS_LEN + 1))
+
+  /** @const Command list of selected variant */
+  extern const uint8_t INIT_ST7735[];
+
+  /** @var Size of current rotation */
+  extern uint8_t st7735Width;
+  extern uint8_t st7735Height;
+
+  /** @const Characters - column bytes */
   extern const uint8_t CHARACTERS[][CHARS_COLS_LEN];
 
+  /** @const Characters - row bytes, column 0 in bit 7 */
+  extern const uint8_t CHARACTERS_ROWS[][CHARS_ROWS_LEN];
+
   /** @enum Font sizes */
   typedef enum {
     // 1x high & 1x wide size
@@ -146,6 +288,17 @@
     X3 = 0x22
   } ESizes;
 
+  /** @enum Rotations - 90 degrees steps from ST7735_MADCTL, done by
+   *        controller (MADCTL); default 0xA0, 0x00, 0x60, 0xC0 */
+  typedef enum {
+    // mounting of init list
+    ROTATE_0 = 0,
+    // next in cycle
+    ROTATE_90 = 1,
+    ROTATE_180 = 2,
+    ROTATE_270 = 3
+  } ERotation;
+
   /**
    * @description     Hardware Reset
    *
@@ -170,6 +323,23 @@
    */
   void St7735Init(void);
 
+  /**
+   * @description     Initialise st7735 driver step by step, caller
+   *                  waits returned time between steps (non-blocking)
+   *
+   * @param void
+   * @return uint16_t delay in ms / ST7735_INIT_DONE
+   */
+  uint16_t St7735InitStep(void);
+
+  /**
+   * @description     Set rotation - MADCTL, size of screen follows
+   *
+   * @param ERotation rotation
+   * @return void
+   */
+  void SetRotation(ERotation);
+
   /**
    * @description     Send list commands
    *
@@ -178,6 +348,14 @@
    */
   void St7735Commands(const uint8_t *commands);
 
+  /**
+   * @description     Send one command of list
+   *
+   * @param uint8_t** command, moved to next command
+   * @return uint8_t delay in ms
+   */
+  uint8_t St7735Command(const uint8_t **commands);
+
   /**
    * @description     Command send
    *
@@ -202,6 +380,15 @@
    */
   uint8_t Data16BitsSend(uint16_t);
 
+  /**
+   * @description     Wait till queued SPI output is sent, sleeps with
+   *                  interrupts enabled, polls with them disabled
+   *
+   * @param void
+   * @return void
+   */
+  void St7735Flush(void);
+
   /**
    * @description     Set window
    *
@@ -250,6 +437,22 @@
    */
   void SendColor565(uint16_t, uint16_t);
 
+  /**
+   * @description     Stream pixel after RAMWR, pairs packed in 12 bits mode
+   *
+   * @param uint16_t  color
+   * @return void
+   */
+  void SendPixel(uint16_t);
+
+  /**
+   * @description     End of pixel stream - sends unpaired pixel
+   *
+   * @param void
+   * @return void
+   */
+  void SendPixelEnd(void);
+
   /**
    * @description     Draw pixel
    *
@@ -280,6 +483,28 @@
    */
   void DrawString(volatile const char*, uint16_t, ESizes);
 
+  /**
+   * @description     Draw character with background, one window
+   *
+   * @param char      character
+   * @param uint16_t  color
+   * @param uint16_t  background
+   * @param Esizes    see enum sizes in st7735.h
+   * @return char
+   */
+  char DrawCharOpaque(char, uint16_t, uint16_t, ESizes);
+
+  /**
+   * @description     Draw string with background, one window per line
+   *
+   * @param char*     string
+   * @param uint16_t  color
+   * @param uint16_t  background
+   * @param Esizes    see enum sizes in st7735.h
+   * @return void
+   */
+  void DrawStringOpaque(const char*, uint16_t, uint16_t, ESizes);
+
   /**
    * @description     Draw line
    *
@@ -326,6 +551,118 @@
    */
   void DrawRectangle(uint8_t, uint8_t, uint8_t, uint8_t, uint16_t);
 
+  /**
+   * @description     Draw circle
+   *
+   * @param uint8_t   x - center position
+   * @param uint8_t   y - center position
+   * @param uint8_t   radius
+   * @param uint16_t  color
+   * @return void
+   */
+  void DrawCircle(uint8_t, uint8_t, uint8_t, uint16_t);
+
+  /**
+   * @description     Fill circle
+   *
+   * @param uint8_t   x - center position
+   * @param uint8_t   y - center position
+   * @param uint8_t   radius
+   * @param uint16_t  color
+   * @return void
+   */
+  void FillCircle(uint8_t, uint8_t, uint8_t, uint16_t);
+
+  /**
+   * @description     Draw rounded rectangle
+   *
+   * @param uint8_t   x - start position
+   * @param uint8_t   x - end position
+   * @param uint8_t   y - start position
+   * @param uint8_t   y - end position
+   * @param uint8_t   corner radius
+   * @param uint16_t  color
+   * @return void
+   */
+  void DrawRoundRectangle(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint16_t);
+
+  /**
+   * @description     Fill rounded rectangle
+   *
+   * @param uint8_t   x - start position
+   * @param uint8_t   x - end position
+   * @param uint8_t   y - start position
+   * @param uint8_t   y - end position
+   * @param uint8_t   corner radius
+   * @param uint16_t  color
+   * @return void
+   */
+  void FillRoundRectangle(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint16_t);
+
+  /**
+   * @description     Draw triangle
+   *
+   * @param uint8_t   x - first vertex
+   * @param uint8_t   y - first vertex
+   * @param uint8_t   x - second vertex
+   * @param uint8_t   y - second vertex
+   * @param uint8_t   x - third vertex
+   * @param uint8_t   y - third vertex
+   * @param uint16_t  color
+   * @return void
+   */
+  void DrawTriangle(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint16_t);
+
+  /**
+   * @description     Fill triangle
+   *
+   * @param uint8_t   x - first vertex
+   * @param uint8_t   y - first vertex
+   * @param uint8_t   x - second vertex
+   * @param uint8_t   y - second vertex
+   * @param uint8_t   x - third vertex
+   * @param uint8_t   y - third vertex
+   * @param uint16_t  color
+   * @return void
+   */
+  void FillTriangle(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint16_t);
+
+
+  /**
+   * @description     Set vertical scroll area
+   *
+   * @param uint8_t   top fixed area in memory rows
+   * @param uint8_t   height of scroll area in memory rows
+   * @return uint8_t
+   */
+  uint8_t SetScrollArea(uint8_t, uint8_t);
+
+  /**
+   * @description     Set vertical scroll start address
+   *
+   * @param uint8_t   memory row shown on top of scroll area
+   * @return void
+   */
+  void SetScrollStart(uint8_t);
+
+  /**
+   * @description     Init scrolling console
+   *
+   * @param uint8_t   top fixed area in memory rows
+   * @param uint8_t   number of lines, 1 .. (SCROLL_LINES - top) / CONSOLE_LINE_HEIGHT
+   * @param uint16_t  text color
+   * @param uint16_t  background color
+   * @return char     ST7735_ERROR if lines do not fit
+   */
+  char ConsoleInit(uint8_t, uint8_t, uint16_t, uint16_t);
+
+  /**
+   * @description     Append line to console
+   *
+   * @param char*     string
+   * @return void
+   */
+  void ConsolePrint(const char *);
 
   /**
    * @description     Clear screen
@@ -0,0 +1,162 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        Software I2C master - parallel buses on one port
+ * -------------------------------------------------------------+ 
+ *
+ * @file        swi.c
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+// include libraries
+#include <string.h>
+#include "swi.h"
+#if defined(__AVR__)
+  #include <util/delay.h>
+#endif
+
+/** @var Buses with SCL held low past limit - kept till next scan */
+static uint8_t swiStuck = 0;
+
+/**
+ * @desc    Release SCL of all buses, wait for clock stretching
+ *          of buses not stuck yet
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+static void SWI_ClockHigh(void)
+{
+  uint8_t mask = SWI_SCL_MASK & (uint8_t) ~(swiStuck << 4);
+  uint8_t wait = SWI_STRETCH_MAX;
+
+  // release clock
+  SWI_RELEASE(SWI_SCL_MASK);
+  // wait till slaves release clock
+  while (((SWI_PIN & mask) != mask) && --wait) {
+    _delay_us(SWI_HALF_US);
+  }
+  // buses still low - stuck one edge stays stuck
+  swiStuck |= (~SWI_PIN & mask) >> 4;
+  // high half period
+  _delay_us(SWI_HALF_US);
+}
+
+/**
+ * @desc    SWI init - release lines of all buses
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+void SWI_Init(void)
+{
+  // lines released, driven low only through DDR
+  SWI_RELEASE(SWI_SDA_MASK | SWI_SCL_MASK);
+  SWI_PORT &= (uint8_t) ~(SWI_SDA_MASK | SWI_SCL_MASK);
+  // no bus stuck
+  swiStuck = 0;
+}
+
+/**
+ * @desc    SWI probe address on all buses at once, buses with SCL
+ *          held low since SWI_Init / SWI_ScanBegin report nothing
+ *          every port write drives the same bit on all buses
+ *
+ * @param   unsigned char address
+ *
+ * @return  uint8_t bit n set - device on bus n acknowledged
+ */
+uint8_t SWI_Probe(unsigned char address)
+{
+  uint8_t data = address << 1;
+  uint8_t bit = 8;
+  uint8_t ack;
+
+  // START - SDA low while SCL high
+  SWI_LOW(SWI_SDA_MASK);
+  _delay_us(SWI_HALF_US);
+  SWI_LOW(SWI_SCL_MASK);
+
+  // SLA+W - MSB first
+  while (bit--) {
+    // data bit while SCL low
+    if (data & (1 << bit)) {
+      SWI_RELEASE(SWI_SDA_MASK);
+    } else {
+      SWI_LOW(SWI_SDA_MASK);
+    }
+    _delay_us(SWI_HALF_US);
+    // clock pulse
+    SWI_ClockHigh();
+    SWI_LOW(SWI_SCL_MASK);
+  }
+
+  // ACK - slave pulls SDA low
+  SWI_RELEASE(SWI_SDA_MASK);
+  _delay_us(SWI_HALF_US);
+  SWI_ClockHigh();
+  ack = ~SWI_PIN & SWI_SDA_MASK;
+  SWI_LOW(SWI_SCL_MASK);
+
+  // STOP - SDA high while SCL high
+  SWI_LOW(SWI_SDA_MASK);
+  _delay_us(SWI_HALF_US);
+  SWI_ClockHigh();
+  SWI_RELEASE(SWI_SDA_MASK);
+  _delay_us(SWI_HALF_US);
+
+  // stuck buses report nothing
+  return ack & ~swiStuck;
+}
+
+/**
+ * @desc    SWI scan begin - bitmaps cleared, stuck buses forgotten
+ *
+ * @param   SWI_ScanState *
+ * @param   unsigned char first address
+ * @param   unsigned char last address
+ *
+ * @return  void
+ */
+void SWI_ScanBegin(SWI_ScanState *scan, unsigned char first, unsigned char last)
+{
+  // clear bitmaps
+  memset(scan->bitmaps, 0, sizeof(scan->bitmaps));
+  // range
+  scan->address = first;
+  scan->last = last;
+  // stuck buses probed again
+  swiStuck = 0;
+}
+
+/**
+ * @desc    SWI scan step - next address on all buses at once
+ *
+ * @param   SWI_ScanState *
+ *
+ * @return  uint8_t 1 addresses left, 0 scan done
+ */
+uint8_t SWI_ScanStep(SWI_ScanState *scan)
+{
+  unsigned char address = scan->address;
+  uint8_t ack;
+  uint8_t bus;
+
+  // scan done, address past 0x7F too
+  if ((address > scan->last) || (address > 0x7F)) {
+    return 0;
+  }
+  // one sequence for all buses
+  ack = SWI_Probe(address);
+  // merge to bitmap of every bus
+  for (bus = 0; bus < SWI_BUSES; bus++) {
+    if (ack & (1 << bus)) {
+      scan->bitmaps[bus][address >> 3] |= (1 << (address & 0x07));
+    }
+  }
+  // next
+  scan->address++;
+  return scan->address <= scan->last;
+}
@@ -0,0 +1,114 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        Software I2C master - parallel buses on one port
+ * -------------------------------------------------------------+ 
+ *
+ * @file        swi.h
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+#include <stdint.h>
+#if defined(__AVR__)
+  #include <avr/io.h>
+#else
+  #include "hostswi.h"
+#endif
+
+#ifndef __SWI_H__
+#define __SWI_H__
+
+  #ifndef F_CPU
+    #define F_CPU 16000000
+  #endif
+
+  // port of all buses - open drain by DDR, PORT bits kept low,
+  // external pull-ups required
+  #ifndef SWI_PORT
+    #define SWI_PORT PORTA
+  #endif
+  #ifndef SWI_DDR
+    #define SWI_DDR  DDRA
+  #endif
+  #ifndef SWI_PIN
+    #define SWI_PIN  PINA
+  #endif
+
+  // number of buses, 1 - 4
+  //  bus n: SDA on bit n, SCL on bit n + 4
+  #ifndef SWI_BUSES
+    #define SWI_BUSES 4
+  #endif
+  #define SWI_SDA_MASK ((1 << SWI_BUSES) - 1)
+  #define SWI_SCL_MASK (SWI_SDA_MASK << 4)
+
+  // bus clock and half period in us
+  #ifndef SWI_FREQ
+    #define SWI_FREQ 100000UL
+  #endif
+  #define SWI_HALF_US (500000.0 / SWI_FREQ)
+
+  // clock stretching limit in half periods
+  #ifndef SWI_STRETCH_MAX
+    #define SWI_STRETCH_MAX 200
+  #endif
+
+  // SDA / SCL low - driven
+  #ifndef SWI_LOW
+    #define SWI_LOW(mask)     { SWI_DDR |= (mask); }
+  #endif
+  // SDA / SCL high - released
+  #ifndef SWI_RELEASE
+    #define SWI_RELEASE(mask) { SWI_DDR &= (uint8_t) ~(mask); }
+  #endif
+
+  /** @struct Scan of all buses in steps of one address */
+  typedef struct {
+    // bit n set - device on bus n acknowledged
+    uint8_t bitmaps[SWI_BUSES][16];
+    // next address
+    unsigned char address;
+    // last address
+    unsigned char last;
+  } SWI_ScanState;
+
+  /**
+   * @desc    SWI init - release lines of all buses
+   *
+   * @param   void
+   *
+   * @return  void
+   */
+  void SWI_Init(void);
+
+  /**
+   * @desc    SWI probe address on all buses at once, buses with SCL
+   *          held low since SWI_Init / SWI_ScanBegin report nothing
+   *
+   * @param   unsigned char address
+   *
+   * @return  uint8_t bit n set - device on bus n acknowledged
+   */
+  uint8_t SWI_Probe(unsigned char);
+
+  /**
+   * @desc    SWI scan begin - bitmaps cleared, stuck buses forgotten
+   *
+   * @param   SWI_ScanState *
+   * @param   unsigned char first address
+   * @param   unsigned char last address
+   *
+   * @return  void
+   */
+  void SWI_ScanBegin(SWI_ScanState *, unsigned char, unsigned char);
+
+  /**
+   * @desc    SWI scan step - next address on all buses at once
+   *
+   * @param   SWI_ScanState *
+   *
+   * @return  uint8_t 1 addresses left, 0 scan done
+   */
+  uint8_t SWI_ScanStep(SWI_ScanState *);
+
+#endif
@@ -0,0 +1,183 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        Last bus topology cached in EEPROM
+ * -------------------------------------------------------------+ 
+ *
+ * @file        topo.c
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+// include libraries
+#include <stddef.h>
+#include <string.h>
+#include <avr/eeprom.h>
+#include "topo.h"
+#include "scanlog.h"
+
+// no write in progress
+#define TOPO_IDLE 0xFF
+
+/** @array Slots in EEPROM */
+static TTopology EEMEM topoSlots[TOPO_SLOTS];
+/** @var Slot of last valid topology */
+static uint8_t topoSlot = TOPO_SLOTS - 1;
+/** @var Sequence number of last valid topology */
+static uint16_t topoSeq = 0;
+/** @var Last valid topology loaded or saved */
+static uint8_t topoValid = 0;
+/** @var Topology being written */
+static TTopology topoWrite;
+/** @var Next byte to write */
+static uint8_t topoByte = TOPO_IDLE;
+/** @var Checksum of last saved content, identical calls */
+static uint16_t topoLast = 0;
+static uint8_t topoStable = 0;
+
+/**
+ * @desc    Checksum of topology without crc
+ *
+ * @param   const TTopology *
+ *
+ * @return  uint16_t
+ */
+static uint16_t TOPO_Crc(const TTopology *topo)
+{
+  const uint8_t *data = (const uint8_t *) topo;
+  uint16_t crc = 0xFFFF;
+  uint8_t i;
+
+  // all bytes before crc
+  for (i = 0; i < offsetof(TTopology, crc); i++) {
+    crc = ScanLogCrc(crc, data[i]);
+  }
+  return crc;
+}
+
+/**
+ * @desc    Load newest valid topology
+ *
+ * @param   TTopology *
+ *
+ * @return  char
+ */
+char TOPO_Load(TTopology *topo)
+{
+  TTopology slot;
+  uint8_t i;
+
+  topoValid = 0;
+  // slot with highest sequence number, wrap around allowed
+  for (i = 0; i < TOPO_SLOTS; i++) {
+    eeprom_read_block(&slot, &topoSlots[i], sizeof(TTopology));
+    // check if slot valid and newer
+    if ((slot.crc == TOPO_Crc(&slot)) &&
+        (!topoValid || ((int16_t) (slot.seq - topoSeq) > 0))) {
+      memcpy(topo, &slot, sizeof(TTopology));
+      topoSeq = slot.seq;
+      topoSlot = i;
+      topoValid = 1;
+    }
+  }
+  // nothing cached
+  if (!topoValid) {
+    return TOPO_ERROR;
+  }
+  return TOPO_SUCCESS;
+}
+
+/**
+ * @desc    Save topology to next slot - write started after
+ *          TOPO_STABLE_SCANS identical calls, skipped if not changed
+ *          or write in progress, bytes written by TOPO_Step
+ *
+ * @param   const TTopology * - seq and crc not used
+ *
+ * @return  char
+ */
+char TOPO_Save(const TTopology *topo)
+{
+  uint16_t crc;
+
+  // check if write in progress
+  if (TOPO_IDLE != topoByte) {
+    return TOPO_BUSY;
+  }
+  // content only - checksum instead of copy of last content
+  memcpy(&topoWrite.bitmap, topo->bitmap, offsetof(TTopology, crc) - offsetof(TTopology, bitmap));
+  topoWrite.seq = 0;
+  crc = TOPO_Crc(&topoWrite);
+  // count identical calls
+  if (crc != topoLast) {
+    topoLast = crc;
+    topoStable = 0;
+  }
+  if (topoStable <= TOPO_STABLE_SCANS) {
+    topoStable++;
+  }
+  // check if stable just now - written once per stable topology
+  if (topoStable != TOPO_STABLE_SCANS) {
+    return TOPO_SUCCESS;
+  }
+  // check if same as last slot - no write, no wear
+  if (topoValid) {
+    eeprom_read_block(&topoWrite, &topoSlots[topoSlot], sizeof(TTopology));
+    if (memcmp(topoWrite.bitmap, topo->bitmap, offsetof(TTopology, crc) - offsetof(TTopology, bitmap)) == 0) {
+      return TOPO_SUCCESS;
+    }
+    memcpy(&topoWrite.bitmap, topo->bitmap, offsetof(TTopology, crc) - offsetof(TTopology, bitmap));
+  }
+  // next slot
+  if (++topoSlot >= TOPO_SLOTS) {
+    topoSlot = 0;
+  }
+  topoWrite.seq = ++topoSeq;
+  topoWrite.crc = TOPO_Crc(&topoWrite);
+  // slot invalid till written and checked
+  topoValid = 0;
+  topoByte = 0;
+  return TOPO_SUCCESS;
+}
+
+/**
+ * @desc    Write one changed byte of saved topology if EEPROM ready,
+ *          check slot after last byte - never waits for EEPROM
+ *
+ * @param   void
+ *
+ * @return  char TOPO_BUSY bytes left, TOPO_SUCCESS nothing to write,
+ *          TOPO_ERROR slot differs after write
+ */
+char TOPO_Step(void)
+{
+  uint8_t *slot = (uint8_t *) &topoSlots[topoSlot];
+  const uint8_t *data = (const uint8_t *) &topoWrite;
+  uint8_t i;
+
+  // nothing to write
+  if (TOPO_IDLE == topoByte) {
+    return TOPO_SUCCESS;
+  }
+  // previous byte still written - no busy wait
+  if (!eeprom_is_ready()) {
+    return TOPO_BUSY;
+  }
+  // unchanged bytes skipped, one write per call
+  while (topoByte < sizeof(TTopology)) {
+    if (eeprom_read_byte(slot + topoByte) != data[topoByte]) {
+      eeprom_write_byte(slot + topoByte, data[topoByte]);
+      topoByte++;
+      return TOPO_BUSY;
+    }
+    topoByte++;
+  }
+  topoByte = TOPO_IDLE;
+  // check written slot
+  for (i = 0; i < sizeof(TTopology); i++) {
+    if (eeprom_read_byte(slot + i) != data[i]) {
+      return TOPO_ERROR;
+    }
+  }
+  topoValid = 1;
+  return TOPO_SUCCESS;
+}
@@ -0,0 +1,85 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        Last bus topology cached in EEPROM
+ * -------------------------------------------------------------+ 
+ *
+ * @file        topo.h
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+#include <stdint.h>
+
+#ifndef __TOPO_H__
+#define __TOPO_H__
+
+  // Slot in EEPROM, written round robin - slot with highest
+  // valid sequence number holds last topology
+  //  +-----+--------+------+------+-------+-----+
+  //  | seq | bitmap | slow | twbr | twsr  | crc |
+  //  +-----+--------+------+------+-------+-----+
+  //     2     16      16      1      1      2
+  //  slow  - addresses probed at reduced speed
+  //  twbr, twsr - bit rate and prescaler of bus
+  //  crc   - CRC-16/CCITT (reflected 0x8408, init 0xFFFF) of seq .. twsr
+  #ifndef TOPO_EEPROM_SIZE
+    #define TOPO_EEPROM_SIZE  512
+  #endif
+  #define TOPO_SLOTS          (TOPO_EEPROM_SIZE / sizeof(TTopology))
+  // identical scans before topology is saved
+  #ifndef TOPO_STABLE_SCANS
+    #define TOPO_STABLE_SCANS 3
+  #endif
+
+  // return values
+  #define TOPO_SUCCESS        0
+  #define TOPO_ERROR          1
+  #define TOPO_BUSY           2
+
+  /** @struct Cached topology */
+  typedef struct {
+    // sequence number of write
+    uint16_t seq;
+    // presence bitmap
+    uint8_t bitmap[16];
+    // slow addresses
+    uint8_t slow[16];
+    // bus speed
+    uint8_t twbr;
+    uint8_t twsr;
+    // checksum
+    uint16_t crc;
+  } TTopology;
+
+  /**
+   * @desc    Load newest valid topology
+   *
+   * @param   TTopology *
+   *
+   * @return  char
+   */
+  char TOPO_Load(TTopology *);
+
+  /**
+   * @desc    Save topology to next slot - write started after
+   *          TOPO_STABLE_SCANS identical calls, skipped if not changed
+   *          or write in progress, bytes written by TOPO_Step
+   *
+   * @param   const TTopology * - seq and crc not used
+   *
+   * @return  char
+   */
+  char TOPO_Save(const TTopology *);
+
+  /**
+   * @desc    Write one changed byte of saved topology if EEPROM ready,
+   *          check slot after last byte - never waits for EEPROM
+   *
+   * @param   void
+   *
+   * @return  char TOPO_BUSY bytes left, TOPO_SUCCESS nothing to write,
+   *          TOPO_ERROR slot differs after write
+   */
+  char TOPO_Step(void);
+
+#endif
@@ -13,7 +13,92 @@
  */
  
 // include libraries
+#include <string.h>
 #include "twi.h"
+#if defined(__AVR__)
+  #include <avr/interrupt.h>
+#endif
+
+/** @var Backoff generator state */
+static uint16_t twiRandom = 0xACE1;
+
+/** @var Slave snapshots - published and back buffer */
+static TWI_Snapshot twiSnapshot[2];
+/** @var Published snapshot */
+static volatile uint8_t twiFront = 0;
+/** @var Snapshot latched by read in progress, 0xFF none */
+static volatile uint8_t twiReading = 0xFF;
+/** @var Slave register pointer */
+static uint8_t twiPointer = 0;
+/** @var Next received byte is register pointer */
+static uint8_t twiPointerNext = 0;
+/** @var Slave mode enabled */
+static volatile uint8_t twiSlave = 0;
+/** @var Slave addressed - bus in use by other master */
+static volatile uint8_t twiSlaveBusy = 0;
+/** @var Arbitration lost in transfer - bus not ours, no STOP */
+static uint8_t twiLost = 0;
+
+/**
+ * @desc    TWI count status of address / data - PERF_COUNTERS
+ *
+ * @param   unsigned char status
+ *
+ * @return  void
+ */
+#ifdef PERF_COUNTERS
+static void TWI_PerfStatus(unsigned char status)
+{
+  switch (status) {
+    case TWI_MT_SLAW_ACK:
+    case TWI_MT_DATA_ACK:
+    case TWI_MR_SLAR_ACK:
+      PERF_INC(twiAcks);
+      break;
+    case TWI_MT_SLAW_NACK:
+    case TWI_MT_DATA_NACK:
+    case TWI_MR_SLAR_NACK:
+      PERF_INC(twiNacks);
+      break;
+    case TWI_FLAG_ARB_LOST:
+      PERF_INC(twiArbLost);
+      break;
+  }
+}
+#else
+  #define TWI_PerfStatus(status) ((void) 0)
+#endif
+
+/**
+ * @desc    TWI status of master byte - arbitration lost to master
+ *          addressing own slave (SLA+W, general call, SLA+R) reported
+ *          as TWI_FLAG_ARB_LOST, ISR serves transfer; TWINT kept set
+ *          after any loss, no STOP sent by this master
+ *
+ * @param   void
+ *
+ * @return  unsigned char
+ */
+static unsigned char TWI_MT_Status(void)
+{
+  unsigned char status = TWI_STATUS;
+
+  // addressed as slave by winner
+  if ((status == TWI_SR_ALMOA_ACK) || (status == TWI_SR_ALMGA_ACK) || (status == TWI_ST_ALMOA_ACK)) {
+    status = TWI_FLAG_ARB_LOST;
+  }
+  TWI_PerfStatus(status);
+  // other master owns bus
+  if (status == TWI_FLAG_ARB_LOST) {
+    twiLost = 1;
+    // lost arbitration may address own slave - TWINT kept set,
+    // ISR takes over
+    if (twiSlave) {
+      TWI_SL_ARM();
+    }
+  }
+  return status;
+}
 
 /**
  * @desc    TWI init - initialize frequency
@@ -41,20 +126,71 @@ void TWI_Init()
 }
 
 /**
- * @desc    TWI MT Start
+ * @desc    TWI set bus speed
+ *
+ * @param   uint16_t speed in kHz
+ *
+ * @return  unsigned char
+ */
+unsigned char TWI_SetSpeed(uint16_t khz)
+{
+  // TWBR = {(fcpu/fclk) - 16 } / (2*4^Prescaler)
+  uint32_t rate;
+  uint8_t prescaler = 0;
+
+  // check if speed out of range
+  if ((khz == 0) || (khz > 400)) {
+    // error
+    return ERROR;
+  }
+  // bit rate with prescaler 1
+  rate = ((_FCPU / 1000UL / khz) - 16) / 2;
+  // lower speeds need prescaler 4, 16, 64
+  while ((rate > 255) && (prescaler < 3)) {
+    rate >>= 2;
+    prescaler++;
+  }
+  // check if speed too low
+  if (rate > 255) {
+    // error
+    return ERROR;
+  }
+  // set bit rate and prescaler
+  TWI_TWBR = (uint8_t) rate;
+  TWI_TWSR = (TWI_TWSR & ~0x03) | prescaler;
+  // success
+  return SUCCESS;
+}
+
+/**
+ * @desc    TWI MT Start - waits at most TWI_SLAVE_WAIT_US (Timer1)
+ *          for transaction of other master with own slave
  *
  * @param   void
  *
- * @return  void
+ * @return  unsigned char SUCCESS / TWI_BUS_BUSY / status
  */
 unsigned char TWI_MT_Start(void)
 {
+  // time of wait start
+  uint16_t start = TCNT1;
+
+  // wait till slave transaction ends
+  while (twiSlaveBusy) {
+    // bus kept by other master - caller retries later
+    if ((uint16_t) (TCNT1 - start) >= TWI_SLAVE_WAIT_US * TWI_TICKS_PER_US) {
+      return TWI_BUS_BUSY;
+    }
+  }
   // null status flag
   TWI_TWSR &= ~0xA8;
+  // bus ours after START
+  twiLost = 0;
   // START
   // ----------------------------------------------
   // request for bus
   TWI_START();
+  PERF_INC(twiStarts);
   // wait till flag set
   TWI_WAIT_TILL_TWINT_IS_SET();
   // test if start acknowledged
@@ -67,7 +203,9 @@ unsigned char TWI_MT_Start(void)
 }
 
 /**
- * @desc    TWI Find address
+ * @desc    TWI Find address - blocking, probe lost in arbitration
+ *          or not started on busy bus repeated after random
+ *          backoff (Timer1, TWI_TimerInit)
  *
  * @param   void
  *
@@ -77,39 +215,392 @@ unsigned char TWI_MT_FindDevice(void)
 {
   // declaration
   unsigned char status = 0x00;
-  unsigned char found = 0x00;
-  unsigned char max_addr = 127;
-
-  for (int i=0; i<max_addr; i++) {
-    // start
-    status = TWI_MT_Start();
-    // start
-    if ((status != SUCCESS) && (status != TWI_REP_START_ACK)) {
-      // return 
-      return 0;
+  unsigned char attempt;
+  unsigned char address;
+  uint16_t ms;
+
+  for (address = TWI_ADDR_FIRST; address <= TWI_ADDR_LAST; address++) {
+    // repeat probe lost in arbitration or not started on busy bus
+    for (attempt = 0; attempt <= TWI_ARB_RETRIES; attempt++) {
+      // probe
+      status = TWI_MT_Probe(address);
+      // check if other master won or holds bus
+      if ((status != TWI_FLAG_ARB_LOST) && (status != TWI_BUS_BUSY)) {
+        break;
+      }
+      // random backoff before next attempt - other master ends
+      // its transaction meanwhile
+      if (attempt < TWI_ARB_RETRIES) {
+        for (ms = TWI_Backoff(attempt + 1); ms; ms--) {
+          TWI_WAIT_MS();
+        }
+      }
     }
-    // SLA+W
+    // found
+    if (status == TWI_MT_SLAW_ACK) {
+      // return found device address
+      return address;
+    }
+  }
+  // nothing found
+  return TWI_NOT_FOUND;
+}
+
+/**
+ * @desc    TWI Probe address - START, SLA+W, STOP
+ *
+ * @param   unsigned char address
+ *
+ * @return  unsigned char
+ */
+unsigned char TWI_MT_Probe(unsigned char address)
+{
+  // declaration
+  uint16_t ticks;
+
+  // probe, time not used
+  return TWI_MT_ProbeTimed(address, &ticks);
+}
+
+/**
+ * @desc    TWI Probe address and measure SLA+W to TWINT
+ *
+ * @param   unsigned char address
+ * @param   uint16_t * timer ticks
+ *
+ * @return  unsigned char
+ */
+unsigned char TWI_MT_ProbeTimed(unsigned char address, uint16_t *ticks)
+{
+  // declaration
+  unsigned char status;
+  uint16_t start;
+
+  // start
+  status = TWI_MT_Start();
+  // start
+  if ((status != SUCCESS) && (status != TWI_REP_START_ACK)) {
+    // return status
+    return status;
+  }
+  // SLA+W
+  // ----------------------------------------------
+  TWI_TWDR = (address << 1);
+  // time of address start
+  start = TCNT1;
+  // enable
+  TWI_ENABLE();
+  // wait till flag set
+  TWI_WAIT_TILL_TWINT_IS_SET();
+  // address and ACK bit incl. clock stretching
+  *ticks = TCNT1 - start;
+  // status of address, own slave addressed by winner reported
+  // as lost arbitration
+  status = TWI_MT_Status();
+  PERF_INC(twiProbes);
+  // bus is released after lost arbitration
+  if ((status == TWI_MT_SLAW_ACK) || (status == TWI_MT_SLAW_NACK)) {
+    // STOP
     // ----------------------------------------------
-    TWI_TWDR = (i << 1);
-    // enable
+    TWI_Stop();
+  }
+  // TWI_MT_SLAW_ACK / TWI_MT_SLAW_NACK / TWI_FLAG_ARB_LOST / TWI_BUS_BUSY
+  return status;
+}
+
+/**
+ * @desc    TWI latency timer init - Timer1 free running
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+void TWI_TimerInit(void)
+{
+  // normal mode, prescaler 8
+  TCCR1A = 0;
+  TCCR1B = (1 << CS11);
+}
+
+/**
+ * @desc    TWI Probe address at speed from profile, update profile
+ *          known slow addresses are probed at TWI_SLOW_KHZ, other
+ *          addresses at current speed
+ *
+ * @param   TWI_Profile *
+ * @param   unsigned char address
+ * @param   unsigned char force slow speed - calibration
+ *
+ * @return  unsigned char
+ */
+unsigned char TWI_MT_ProbeAdaptive(TWI_Profile *profile, unsigned char address, unsigned char calibrate)
+{
+  // declaration
+  unsigned char status;
+  uint8_t bitrate = TWI_TWBR;
+  uint8_t prescaler = TWI_TWSR & 0x03;
+  uint8_t slow = calibrate || (profile->slow[address >> 3] & (1 << (address & 0x07)));
+  uint16_t ticks;
+  uint16_t nominal;
+
+  // slow speed
+  if (slow) {
+    TWI_SetSpeed(TWI_SLOW_KHZ);
+  }
+  // 9 bit times in timer ticks - fclk = fcpu/(16+2*TWBR*4^Prescaler)
+  nominal = 9UL * (16 + 2UL * TWI_TWBR * (1 << (2 * (TWI_TWSR & 0x03)))) / TWI_TIMER_PRESCALER;
+  // probe
+  status = TWI_MT_ProbeTimed(address, &ticks);
+  // restore speed
+  if (slow) {
+    TWI_TWBR = bitrate;
+    TWI_TWSR = (TWI_TWSR & ~0x03) | prescaler;
+  }
+  // profile only answering devices
+  if (status == TWI_MT_SLAW_ACK) {
+    // excess over nominal
+    ticks = (ticks > nominal) ? (ticks - nominal) : 0;
+    ticks /= TWI_STRETCH_UNIT_US * TWI_TICKS_PER_US;
+    profile->stretch[address] = (ticks > 255) ? 255 : ticks;
+    // mark slow - kept till next calibration
+    if (profile->stretch[address] * TWI_STRETCH_UNIT_US > TWI_SLOW_US) {
+      profile->slow[address >> 3] |= (1 << (address & 0x07));
+    } else if (calibrate) {
+      profile->slow[address >> 3] &= ~(1 << (address & 0x07));
+    }
+  } else if (calibrate && (status == TWI_MT_SLAW_NACK)) {
+    // absent at slow speed
+    profile->stretch[address] = 0;
+    profile->slow[address >> 3] &= ~(1 << (address & 0x07));
+  }
+  // status
+  return status;
+}
+
+/**
+ * @desc    TWI send byte - address or data
+ *
+ * @param   unsigned char byte
+ *
+ * @return  unsigned char
+ */
+static unsigned char TWI_MT_Send(unsigned char data)
+{
+  // data
+  TWI_TWDR = data;
+  // enable
+  TWI_ENABLE();
+  // wait till flag set
+  TWI_WAIT_TILL_TWINT_IS_SET();
+  // status, lost arbitration released
+  return TWI_MT_Status();
+}
+
+/**
+ * @desc    TWI write register - START, SLA+W, reg, data, STOP
+ *
+ * @param   unsigned char address
+ * @param   unsigned char register
+ * @param   unsigned char value
+ *
+ * @return  unsigned char
+ */
+unsigned char TWI_MT_WriteReg(unsigned char address, unsigned char reg, unsigned char value)
+{
+  // declaration
+  unsigned char status = ERROR;
+
+  // start
+  if (TWI_MT_Start() != SUCCESS) {
+    return ERROR;
+  }
+  // SLA+W, register, value
+  if ((TWI_MT_Send(address << 1) == TWI_MT_SLAW_ACK) &&
+      (TWI_MT_Send(reg) == TWI_MT_DATA_ACK) &&
+      (TWI_MT_Send(value) == TWI_MT_DATA_ACK)) {
+    status = SUCCESS;
+  }
+  // STOP
+  TWI_Stop();
+  // return status
+  return status;
+}
+
+/**
+ * @desc    TWI write bytes - START, SLA+W, data, STOP
+ *
+ * @param   unsigned char address
+ * @param   const uint8_t * data
+ * @param   uint16_t length
+ *
+ * @return  unsigned char
+ */
+unsigned char TWI_MT_Write(unsigned char address, const uint8_t *data, uint16_t length)
+{
+  // declaration
+  unsigned char status = ERROR;
+
+  // start
+  if (TWI_MT_Start() != SUCCESS) {
+    return ERROR;
+  }
+  // SLA+W
+  if (TWI_MT_Send(address << 1) == TWI_MT_SLAW_ACK) {
+    // data till NOT ACK
+    while (length && (TWI_MT_Send(*data++) == TWI_MT_DATA_ACK)) {
+      length--;
+    }
+    // all acknowledged
+    if (length == 0) {
+      status = SUCCESS;
+    }
+  }
+  // STOP
+  TWI_Stop();
+  // return status
+  return status;
+}
+
+/**
+ * @desc    TWI write register and bytes - START, SLA+W, reg, data, STOP
+ *
+ * @param   unsigned char address
+ * @param   unsigned char register / control byte
+ * @param   const uint8_t * data
+ * @param   uint16_t length
+ *
+ * @return  unsigned char
+ */
+unsigned char TWI_MT_WriteRegs(unsigned char address, unsigned char reg, const uint8_t *data, uint16_t length)
+{
+  // declaration
+  unsigned char status = ERROR;
+
+  // start
+  if (TWI_MT_Start() != SUCCESS) {
+    return ERROR;
+  }
+  // SLA+W, register
+  if ((TWI_MT_Send(address << 1) == TWI_MT_SLAW_ACK) &&
+      (TWI_MT_Send(reg) == TWI_MT_DATA_ACK)) {
+    // data till NOT ACK
+    while (length && (TWI_MT_Send(*data++) == TWI_MT_DATA_ACK)) {
+      length--;
+    }
+    // all acknowledged
+    if (length == 0) {
+      status = SUCCESS;
+    }
+  }
+  // STOP
+  TWI_Stop();
+  // return status
+  return status;
+}
+
+/**
+ * @desc    TWI read byte - START, SLA+R, data, STOP
+ *
+ * @param   unsigned char address
+ * @param   unsigned char * value
+ *
+ * @return  unsigned char
+ */
+unsigned char TWI_MR_Read(unsigned char address, unsigned char *value)
+{
+  // declaration
+  unsigned char status = ERROR;
+
+  // start
+  if (TWI_MT_Start() != SUCCESS) {
+    return ERROR;
+  }
+  // SLA+R
+  if (TWI_MT_Send((address << 1) | 1) == TWI_MR_SLAR_ACK) {
+    // one byte, NOT ACK
     TWI_ENABLE();
-    // wait till flag set
     TWI_WAIT_TILL_TWINT_IS_SET();
+    if (TWI_STATUS == TWI_MR_DATA_NACK) {
+      *value = TWI_TWDR;
+      status = SUCCESS;
+    }
+  }
+  // STOP
+  TWI_Stop();
+  // return status
+  return status;
+}
 
-    // find
-    if (TWI_STATUS == TWI_MT_SLAW_ACK) {
-      // found
-      found = i;
-      // cancel looop
-      break;
-      // STOP
-      // ----------------------------------------------
-      // stop TWI
-      TWI_Stop();
+/**
+ * @desc    TWI read register - START, SLA+W, reg, REP START, SLA+R, data, STOP
+ *
+ * @param   unsigned char address
+ * @param   unsigned char register
+ * @param   unsigned char * value
+ *
+ * @return  unsigned char
+ */
+unsigned char TWI_MR_ReadReg(unsigned char address, unsigned char reg, unsigned char *value)
+{
+  // declaration
+  unsigned char status = ERROR;
+
+  // start
+  if (TWI_MT_Start() != SUCCESS) {
+    return ERROR;
+  }
+  // SLA+W, register
+  if ((TWI_MT_Send(address << 1) == TWI_MT_SLAW_ACK) &&
+      (TWI_MT_Send(reg) == TWI_MT_DATA_ACK)) {
+    // repeated start
+    TWI_START();
+    PERF_INC(twiStarts);
+    TWI_WAIT_TILL_TWINT_IS_SET();
+    // SLA+R
+    if ((TWI_STATUS == TWI_REP_START_ACK) &&
+        (TWI_MT_Send((address << 1) | 1) == TWI_MR_SLAR_ACK)) {
+      // one byte, NOT ACK
+      TWI_ENABLE();
+      TWI_WAIT_TILL_TWINT_IS_SET();
+      if (TWI_STATUS == TWI_MR_DATA_NACK) {
+        *value = TWI_TWDR;
+        status = SUCCESS;
+      }
     }
   }
-  // return found device address
-  return found;
+  // STOP
+  TWI_Stop();
+  // return status
+  return status;
+}
+
+/**
+ * @desc    TWI seed of backoff generator
+ *
+ * @param   uint16_t seed
+ *
+ * @return  void
+ */
+void TWI_Seed(uint16_t seed)
+{
+  // zero state would stop generator
+  twiRandom = seed ? seed : 0xACE1;
+}
+
+/**
+ * @desc    TWI random backoff after lost arbitration
+ *          16 bit Galois LFSR, window doubled every attempt
+ *
+ * @param   unsigned char attempt 1 .. TWI_ARB_RETRIES
+ *
+ * @return  uint16_t ms 1 .. TWI_BACKOFF_MS << attempt
+ */
+uint16_t TWI_Backoff(unsigned char attempt)
+{
+  // next random state
+  twiRandom = (twiRandom >> 1) ^ (-(twiRandom & 1) & 0xB400);
+  // random time in window
+  return 1 + (twiRandom % (TWI_BACKOFF_MS << attempt));
 }
 
 /**
@@ -121,10 +612,145 @@ unsigned char TWI_MT_FindDevice(void)
  */
 void TWI_Stop(void)
 {
+  // bus of other master after lost arbitration - own slave armed
+  // already, STOP would end transfer served by ISR
+  if (twiLost) {
+    twiLost = 0;
+    return;
+  }
   // End TWI
   // -------------------------------------------------
   // send stop sequence
   TWI_STOP();
-  // wait for TWINT flag is set
-  TWI_WAIT_TILL_TWINT_IS_SET();
+  // wait till stop sent - TWINT is not set after stop
+  TWI_WAIT_TILL_TWSTO_IS_CLEARED();
+  // check if slave mode enabled
+  if (twiSlave) {
+    // answer own address again
+    TWI_SL_ARM();
+  }
+}
+
+/**
+ * @desc    TWI slave init - answer at own address from ISR
+ *
+ * @param   unsigned char 7 bit own address
+ *
+ * @return  void
+ */
+void TWI_SL_Init(unsigned char address)
+{
+  // own address, general call not recognized
+  TWI_TWAR = (address << 1);
+  // empty snapshots
+  memset(twiSnapshot, 0, sizeof(twiSnapshot));
+  // slave mode
+  twiSlave = 1;
+  // acknowledge own address
+  TWI_SL_ARM();
+  // enable interrupts
+  sei();
+}
+
+/**
+ * @desc    TWI slave publish scan results
+ *          copied to buffer not read by ISR, then swapped
+ *
+ * @param   const TWI_Snapshot *
+ *
+ * @return  unsigned char
+ */
+unsigned char TWI_SL_Publish(const TWI_Snapshot *snapshot)
+{
+  // back buffer
+  uint8_t back = twiFront ^ 1;
+
+  // check if read of older snapshot still in progress
+  if (twiReading == back) {
+    // try later
+    return ERROR;
+  }
+  // fill back buffer
+  memcpy(&twiSnapshot[back], snapshot, sizeof(TWI_Snapshot));
+  // publish
+  twiFront = back;
+  // success
+  return SUCCESS;
+}
+
+/**
+ * @desc    TWI slave register read with auto increment
+ *
+ * @param   void
+ *
+ * @return  uint8_t
+ */
+static uint8_t TWI_SL_Next(void)
+{
+  // check if pointer out of map
+  if (twiPointer >= TWI_SL_REG_SIZE) {
+    // empty
+    return 0xFF;
+  }
+  // register of latched snapshot
+  return ((const uint8_t *) &twiSnapshot[twiReading])[twiPointer++];
+}
+
+/**
+ * @desc    TWI slave state machine
+ *
+ * @param   TWI_vect
+ *
+ * @return  void
+ */
+ISR(TWI_vect)
+{
+  switch (TWI_STATUS) {
+    // own SLA+W - register pointer follows
+    case TWI_SR_SLAW_ACK:
+    case TWI_SR_ALMOA_ACK:
+      twiSlaveBusy = 1;
+      twiPointerNext = 1;
+      break;
+    // data received
+    case TWI_SR_OA_DATA_ACK:
+      // first byte is register pointer, registers are read only
+      if (twiPointerNext) {
+        twiPointer = TWI_TWDR;
+        twiPointerNext = 0;
+      }
+      break;
+    // own SLA+R - latch published snapshot
+    case TWI_ST_OA_ACK:
+    case TWI_ST_ALMOA_ACK:
+      twiSlaveBusy = 1;
+      twiReading = twiFront;
+      TWI_TWDR = TWI_SL_Next();
+      break;
+    // data transmitted, master wants more
+    case TWI_ST_DATA_ACK:
+      TWI_TWDR = TWI_SL_Next();
+      break;
+    // master ends read
+    case TWI_ST_DATA_NACK:
+    case TWI_ST_DATA_LOST_ACK:
+      twiReading = 0xFF;
+      twiSlaveBusy = 0;
+      break;
+    // end of write
+    case TWI_SR_STOP_RSTART:
+    case TWI_SR_OA_DATA_NACK:
+      twiSlaveBusy = 0;
+      break;
+    // bus error - release lines
+    case TWI_BUS_ERROR:
+      twiReading = 0xFF;
+      twiSlaveBusy = 0;
+      TWI_TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWEA) | (1 << TWINT) | (1 << TWSTO);
+      return;
+    default:
+      break;
+  }
+  // clear flag, acknowledge next byte
+  TWI_SL_ACK();
 }
@@ -13,7 +13,13 @@
  */
 
 #include <stdio.h>
-#include <avr/io.h>
+#include <stdint.h>
+#if defined(__AVR__)
+  #include <avr/io.h>
+#else
+  #include "hosttwi.h"
+#endif
+#include "perf.h"
 
 #ifndef __TWI_H__
 #define __TWI_H__
@@ -61,8 +67,28 @@
   // (1 << TWSTO) - TWI Stop
   #define TWI_STOP() { TWI_TWCR = (1 << TWEN) | (1 << TWINT) | (1 << TWSTO); }
 
-  // TWI test if TWINT Flag is set
-  #define TWI_WAIT_TILL_TWINT_IS_SET() { while (!(TWI_TWCR & (1 << TWINT))); }
+  // TWI slave armed - own address acknowledged, interrupt driven
+  // (1 <<  TWEN) - TWI Enable
+  // (1 <<  TWIE) - TWI Interrupt Enable
+  // (1 <<  TWEA) - TWI Enable Acknowledge
+  #define TWI_SL_ARM() { TWI_TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWEA); }
+
+  // TWI slave continue - clear TWINT and acknowledge next byte
+  #define TWI_SL_ACK() { TWI_TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWEA) | (1 << TWINT); }
+
+  // TWI test if TWINT Flag is set, iterations counted (PERF_COUNTERS)
+  #ifndef TWI_WAIT_TILL_TWINT_IS_SET
+    #define TWI_WAIT_TILL_TWINT_IS_SET() { while (!(TWI_TWCR & (1 << TWINT))) { PERF_INC(twiWaits); } }
+  #endif
+
+  // TWI test if stop condition is sent
+  #ifndef TWI_WAIT_TILL_TWSTO_IS_CLEARED
+    #define TWI_WAIT_TILL_TWSTO_IS_CLEARED() { while (TWI_TWCR & (1 << TWSTO)); }
+  #endif
+  // wait 1 ms on Timer1 (TWI_TimerInit) - backoff of blocking calls
+  #ifndef TWI_WAIT_MS
+    #define TWI_WAIT_MS() { uint16_t tick = TCNT1; while ((uint16_t) (TCNT1 - tick) < 1000U * TWI_TICKS_PER_US); }
+  #endif
 
   // TWI status mask
   #define TWI_STATUS (TWI_TWSR & 0xF8)
@@ -72,6 +98,12 @@
   // success return value
   #define ERROR 1
 
+  // scanned addresses - reserved addresses excluded
+  #define TWI_ADDR_FIRST 0x08
+  #define TWI_ADDR_LAST  0x77
+  // presence bitmap size - one bit per 7 bit address
+  #define TWI_BITMAP_SIZE 16
+
   // ++++++++++++++++++++++++++++++++++++++++++
   //
   //        M A S T E R   M O D E
@@ -114,6 +146,103 @@
   #define TWI_ST_DATA_ACK       0xB8  // Data byte in TWDR has been transmitted; ACK has been received
   #define TWI_ST_DATA_NACK      0xC0  // Data byte in TWDR has been transmitted; NOT ACK has been received
   #define TWI_ST_DATA_LOST_ACK  0xC8  // Last data byte in TWDR has been transmitted (TWEA = '0'); ACK has been received
+  // Misc
+  #define TWI_BUS_ERROR         0x00  // Bus error due to an illegal START or STOP condition
+
+  // ++++++++++++++++++++++++++++++++++++++++++
+  //
+  //    S L A V E   R E G I S T E R   M A P
+  //
+  // ++++++++++++++++++++++++++++++++++++++++++
+  // Master writes register pointer, then reads with auto increment
+  //   multi byte values are little endian
+  #define TWI_SL_REG_BITMAP     0x00  // 16 bytes presence bitmap, bit (addr & 7) of byte (addr >> 3)
+  #define TWI_SL_REG_SCANS      0x10  // number of finished scans
+  #define TWI_SL_REG_ACKS       0x12  // addresses acknowledged in last scan
+  #define TWI_SL_REG_NACKS      0x14  // addresses not acknowledged in last scan
+  #define TWI_SL_REG_TIME       0x16  // duration of last scan in ms
+  #define TWI_SL_REG_ARB_LOST   0x18  // probes lost arbitration in last scan
+  #define TWI_SL_REG_GIVE_UPS   0x1A  // addresses skipped after TWI_ARB_RETRIES in last scan
+  #define TWI_SL_REG_SIZE       0x1C  // reads past map return 0xFF
+
+  /** @struct Scan results served in slave mode - layout of register map */
+  typedef struct {
+    // presence bitmap
+    uint8_t bitmap[TWI_BITMAP_SIZE];
+    // number of finished scans
+    uint16_t scans;
+    // acknowledged addresses
+    uint16_t acks;
+    // not acknowledged addresses
+    uint16_t nacks;
+    // scan duration in ms
+    uint16_t time;
+    // probes lost arbitration
+    uint16_t arbLost;
+    // addresses skipped
+    uint16_t giveUps;
+  } TWI_Snapshot;
+
+  // ++++++++++++++++++++++++++++++++++++++++++
+  //
+  //   M U L T I   M A S T E R   B U S
+  //
+  // ++++++++++++++++++++++++++++++++++++++++++
+  // probe repeated after lost arbitration
+  #ifndef TWI_ARB_RETRIES
+    #define TWI_ARB_RETRIES     5
+  #endif
+  // backoff window in ms, doubled every retry
+  #ifndef TWI_BACKOFF_MS
+    #define TWI_BACKOFF_MS      2
+  #endif
+  // wait for transaction of other master with own slave, in us
+  #ifndef TWI_SLAVE_WAIT_US
+    #define TWI_SLAVE_WAIT_US   500
+  #endif
+  // own slave still addressed - START not sent, retried like lost arbitration
+  #define TWI_BUS_BUSY          0xF0
+  // no device found
+  #define TWI_NOT_FOUND         0xFF
+
+  // ++++++++++++++++++++++++++++++++++++++++++
+  //
+  //   S L O W   D E V I C E S
+  //
+  // ++++++++++++++++++++++++++++++++++++++++++
+  // Timer1 free running, prescaler 8, measures SLA+W to TWINT
+  #define TWI_TIMER_PRESCALER   8
+  #define TWI_TICKS_PER_US      (_FCPU / TWI_TIMER_PRESCALER / 1000000UL)
+  // unit of stretch table
+  #define TWI_STRETCH_UNIT_US   4
+  // stretch over which address is probed slowly
+  #ifndef TWI_SLOW_US
+    #define TWI_SLOW_US         20
+  #endif
+  // speed of slow probes
+  #ifndef TWI_SLOW_KHZ
+    #define TWI_SLOW_KHZ        25
+  #endif
+
+  /** @struct Latency profile - excess of SLA+W over 9 bit times */
+  typedef struct {
+    // stretch per address in TWI_STRETCH_UNIT_US, saturated
+    uint8_t stretch[128];
+    // addresses probed at TWI_SLOW_KHZ
+    uint8_t slow[TWI_BITMAP_SIZE];
+  } TWI_Profile;
+
+  /** @struct Contention statistics */
+  typedef struct {
+    // probes lost arbitration
+    uint16_t arbLost;
+    // probes repeated after backoff
+    uint16_t retries;
+    // addresses skipped after TWI_ARB_RETRIES
+    uint16_t giveUps;
+    // probes ended by bus error or unexpected status
+    uint16_t busErrors;
+  } TWI_Contention;
   
   /**
    * @desc    TWI init - initialise communication
@@ -125,24 +254,148 @@
   void TWI_Init();
 
   /**
-   * @desc    TWI MT Start
+   * @desc    TWI set bus speed
+   *
+   * @param   uint16_t speed in kHz
+   *
+   * @return  unsigned char
+   */
+  unsigned char TWI_SetSpeed(uint16_t);
+
+  /**
+   * @desc    TWI MT Start - waits at most TWI_SLAVE_WAIT_US (Timer1)
+   *          for transaction of other master with own slave
    *
    * @param   void
    *
-   * @return  void
+   * @return  unsigned char SUCCESS / TWI_BUS_BUSY / status
    */
   unsigned char TWI_MT_Start(void);
 
 
   /**
-   * @desc    TWI Find device
+   * @desc    TWI Find device - blocking, probe lost in arbitration
+   *          or not started on busy bus repeated after random
+   *          backoff (Timer1, TWI_TimerInit)
    *
    * @param   void
    *
-   * @return  unsigned char
+   * @return  unsigned char first address found or TWI_NOT_FOUND
    */
   unsigned char TWI_MT_FindDevice(void);
 
+  /**
+   * @desc    TWI Probe address
+   *
+   * @param   unsigned char address
+   *
+   * @return  unsigned char
+   */
+  unsigned char TWI_MT_Probe(unsigned char);
+
+  /**
+   * @desc    TWI write register
+   *
+   * @param   unsigned char address
+   * @param   unsigned char register
+   * @param   unsigned char value
+   *
+   * @return  unsigned char
+   */
+  unsigned char TWI_MT_WriteReg(unsigned char, unsigned char, unsigned char);
+
+  /**
+   * @desc    TWI write bytes
+   *
+   * @param   unsigned char address
+   * @param   const uint8_t * data
+   * @param   uint16_t length
+   *
+   * @return  unsigned char
+   */
+  unsigned char TWI_MT_Write(unsigned char, const uint8_t *, uint16_t);
+
+  /**
+   * @desc    TWI write register followed by bytes in one transaction
+   *
+   * @param   unsigned char address
+   * @param   unsigned char register / control byte
+   * @param   const uint8_t * data
+   * @param   uint16_t length
+   *
+   * @return  unsigned char
+   */
+  unsigned char TWI_MT_WriteRegs(unsigned char, unsigned char, const uint8_t *, uint16_t);
+
+  /**
+   * @desc    TWI read byte
+   *
+   * @param   unsigned char address
+   * @param   unsigned char * value
+   *
+   * @return  unsigned char
+   */
+  unsigned char TWI_MR_Read(unsigned char, unsigned char *);
+
+  /**
+   * @desc    TWI read register
+   *
+   * @param   unsigned char address
+   * @param   unsigned char register
+   * @param   unsigned char * value
+   *
+   * @return  unsigned char
+   */
+  unsigned char TWI_MR_ReadReg(unsigned char, unsigned char, unsigned char *);
+
+  /**
+   * @desc    TWI latency timer init - Timer1 free running
+   *
+   * @param   void
+   *
+   * @return  void
+   */
+  void TWI_TimerInit(void);
+
+  /**
+   * @desc    TWI Probe address and measure SLA+W to TWINT
+   *
+   * @param   unsigned char address
+   * @param   uint16_t * timer ticks
+   *
+   * @return  unsigned char
+   */
+  unsigned char TWI_MT_ProbeTimed(unsigned char, uint16_t *);
+
+  /**
+   * @desc    TWI Probe address at speed from profile, update profile
+   *
+   * @param   TWI_Profile *
+   * @param   unsigned char address
+   * @param   unsigned char force slow speed
+   *
+   * @return  unsigned char
+   */
+  unsigned char TWI_MT_ProbeAdaptive(TWI_Profile *, unsigned char, unsigned char);
+
+  /**
+   * @desc    TWI seed of backoff generator
+   *
+   * @param   uint16_t seed
+   *
+   * @return  void
+   */
+  void TWI_Seed(uint16_t);
+
+  /**
+   * @desc    TWI random backoff after lost arbitration
+   *
+   * @param   unsigned char attempt 1 .. TWI_ARB_RETRIES
+   *
+   * @return  uint16_t ms 1 .. TWI_BACKOFF_MS << attempt
+   */
+  uint16_t TWI_Backoff(unsigned char);
+
   /**
    * @desc    TWI stop
    *
@@ -151,5 +404,23 @@
    * @return  void
    */
   void TWI_Stop(void);
+
+  /**
+   * @desc    TWI slave init - answer at own address from ISR
+   *
+   * @param   unsigned char 7 bit own address
+   *
+   * @return  void
+   */
+  void TWI_SL_Init(unsigned char);
+
+  /**
+   * @desc    TWI slave publish scan results
+   *
+   * @param   const TWI_Snapshot *
+   *
+   * @return  unsigned char
+   */
+  unsigned char TWI_SL_Publish(const TWI_Snapshot *);
   
 #endif
@@ -0,0 +1,254 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        I2C switch traversal (TCA9548A like)
+ * -------------------------------------------------------------+ 
+ *
+ * @file        twimux.c
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+// include libraries
+#include <string.h>
+#include "twimux.h"
+
+// bit of address in bitmap
+#define MUX_BIT(bitmap, address) ((bitmap)[(address) >> 3] & (1 << ((address) & 0x07)))
+
+/**
+ * @desc    Enable switch channels
+ *
+ * @param   unsigned char switch address
+ * @param   uint8_t channels
+ *
+ * @return  unsigned char
+ */
+static unsigned char MUX_Select(unsigned char address, uint8_t channels)
+{
+  // control register is the only register
+  return TWI_MT_Write(address, &channels, 1);
+}
+
+/**
+ * @desc    Check if device is switch - control register read twice
+ *          gives same byte, then channels off (0x00) written and
+ *          read back as 0; device passing reads is the only one
+ *          written to
+ *
+ * @param   unsigned char address
+ *
+ * @return  char
+ */
+static char MUX_Is(unsigned char address)
+{
+  unsigned char first;
+  unsigned char second;
+
+  // single register - reads without pointer return same value
+  if ((TWI_MR_Read(address, &first) != SUCCESS) ||
+      (TWI_MR_Read(address, &second) != SUCCESS) ||
+      (first != second)) {
+    return 0;
+  }
+  // register holds written value - channels off read back as 0
+  return (MUX_Select(address, 0x00) == SUCCESS) &&
+         (TWI_MR_Read(address, &second) == SUCCESS) &&
+         (second == 0x00);
+}
+
+/**
+ * @desc    Probe addresses of mask not present upstream, from next
+ *          address on - lost address left in next
+ *
+ * @param   uint8_t * found
+ * @param   const uint8_t * mask, NULL all
+ * @param   const uint8_t * upstream
+ * @param   uint8_t * next address, first of step before start
+ * @param   unsigned char last address
+ * @param   uint16_t * number of probes
+ *
+ * @return  unsigned char SUCCESS, TWI_FLAG_ARB_LOST / TWI_BUS_BUSY - bitmap incomplete
+ */
+static unsigned char MUX_Probe(uint8_t *found, const uint8_t *mask, const uint8_t *upstream,
+                               uint8_t *next, unsigned char last, uint16_t *probes)
+{
+  unsigned char address;
+  unsigned char status;
+
+  // loop through addresses
+  for (address = *next; address <= last; address++) {
+    *next = address;
+    // upstream devices answer on every channel
+    if (MUX_BIT(upstream, address)) {
+      continue;
+    }
+    // only candidates of mask
+    if (mask && !MUX_BIT(mask, address)) {
+      continue;
+    }
+    // probe
+    (*probes)++;
+    status = TWI_MT_Probe(address);
+    if (status == TWI_MT_SLAW_ACK) {
+      found[address >> 3] |= (1 << (address & 0x07));
+    // other master on bus - step goes on from this address
+    } else if ((status == TWI_FLAG_ARB_LOST) || (status == TWI_BUS_BUSY)) {
+      return status;
+    }
+  }
+  return SUCCESS;
+}
+
+/**
+ * @desc    Find switches on upstream segment - control register
+ *          read twice, channels off written only to devices
+ *          passing reads
+ *
+ * @param   TMuxMap *
+ * @param   const uint8_t * upstream presence bitmap
+ *
+ * @return  uint8_t number of switches
+ */
+uint8_t MUX_Detect(TMuxMap *map, const uint8_t *upstream)
+{
+  unsigned char address;
+
+  memset(map, 0, sizeof(TMuxMap));
+  // answering addresses of switch range
+  for (address = MUX_ADDR_FIRST; address <= MUX_ADDR_LAST; address++) {
+    if (MUX_BIT(upstream, address) && (map->count < MUX_MAX) && MUX_Is(address)) {
+      map->mux[map->count++].address = address;
+    }
+  }
+  return map->count;
+}
+
+/**
+ * @desc    Start traversal of detected switches
+ *
+ * @param   TMuxMap *
+ *
+ * @return  void
+ */
+void MUX_Begin(TMuxMap *map)
+{
+  map->probes = 0;
+  map->index = 0;
+  map->step = MUX_STEP_ALL;
+  map->next = 0;
+}
+
+/**
+ * @desc    Next step, next switch after channels off
+ *
+ * @param   TMuxMap *
+ *
+ * @return  void
+ */
+static void MUX_Next(TMuxMap *map)
+{
+  // step not started
+  map->next = 0;
+  // switch done
+  if (++map->step > MUX_STEP_OFF) {
+    map->step = MUX_STEP_ALL;
+    map->index++;
+  }
+}
+
+/**
+ * @desc    Step given up - its result cleared, traversal goes on
+ *
+ * @param   TMuxMap *
+ *
+ * @return  void
+ */
+void MUX_Skip(TMuxMap *map)
+{
+  TMux *mux = &map->mux[map->index];
+
+  // all switches done
+  if (map->index >= map->count) {
+    return;
+  }
+  // all channels unknown - channels probe nothing
+  if (map->step == MUX_STEP_ALL) {
+    memset(mux->devices, 0, TWI_BITMAP_SIZE);
+  }
+  // channel unknown - not reported
+  // next step
+  MUX_Next(map);
+}
+
+/**
+ * @desc    Traversal step - all channels of switch, one channel
+ *          or channels off; step repeated after MUX_RETRY
+ *          all channels open at once give union of downstream
+ *          devices, then every channel probes only the union and
+ *          its result is left in map->channel till next step
+ *
+ * @param   TMuxMap *
+ * @param   const uint8_t * upstream presence bitmap
+ * @param   unsigned char first address
+ * @param   unsigned char last address
+ *
+ * @return  uint8_t MUX_MORE / MUX_CHANNEL / MUX_DONE / MUX_RETRY lost
+ *          arbitration, bus busy
+ */
+uint8_t MUX_Step(TMuxMap *map, const uint8_t *upstream, unsigned char first, unsigned char last)
+{
+  unsigned char status = SUCCESS;
+  uint8_t result = MUX_MORE;
+  uint8_t start = map->next;
+  uint8_t channel;
+  TMux *mux;
+
+  // all switches done
+  if (map->index >= map->count) {
+    return MUX_DONE;
+  }
+  mux = &map->mux[map->index];
+  // switch gone from upstream segment - nothing behind it
+  if (!MUX_BIT(upstream, mux->address)) {
+    memset(mux->devices, 0, TWI_BITMAP_SIZE);
+    map->step = MUX_STEP_OFF;
+  // all channels - union of downstream devices
+  } else if (map->step == MUX_STEP_ALL) {
+    // bitmap cleared at start of step
+    if (!map->next) {
+      memset(mux->devices, 0, TWI_BITMAP_SIZE);
+      map->next = start = first;
+    }
+    status = MUX_Select(mux->address, 0xFF);
+    if (status == SUCCESS) {
+      status = MUX_Probe(mux->devices, NULL, upstream, &map->next, last, &map->probes);
+    }
+  // one channel - only union candidates
+  } else if (map->step <= MUX_CHANNELS) {
+    channel = map->step - 1;
+    // bitmap cleared at start of step
+    if (!map->next) {
+      memset(map->channel.devices, 0, TWI_BITMAP_SIZE);
+      map->next = start = first;
+    }
+    status = MUX_Select(mux->address, 1 << channel);
+    if (status == SUCCESS) {
+      status = MUX_Probe(map->channel.devices, mux->devices, upstream, &map->next, last, &map->probes);
+    }
+    // result of channel
+    map->channel.address = mux->address;
+    map->channel.number = channel;
+    result = MUX_CHANNEL;
+  // all channels off
+  } else {
+    status = MUX_Select(mux->address, 0x00);
+  }
+  // goes on from lost address - progress made, or repeated
+  // later - switch or bus busy
+  if (status != SUCCESS) {
+    return (map->next != start) ? MUX_MORE : MUX_RETRY;
+  }
+  // next step
+  MUX_Next(map);
+  return (map->index < map->count) ? result : MUX_DONE;
+}
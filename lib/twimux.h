@@ -0,0 +1,114 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        I2C switch traversal (TCA9548A like)
+ * -------------------------------------------------------------+ 
+ *
+ * @file        twimux.h
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+#include <stdint.h>
+#include "twi.h"
+
+#ifndef __TWIMUX_H__
+#define __TWIMUX_H__
+
+  // switch addresses
+  #define MUX_ADDR_FIRST 0x70
+  #define MUX_ADDR_LAST  0x77
+  // downstream channels, control register bit n enables channel n
+  #define MUX_CHANNELS   8
+  // max switches mapped - 17 bytes RAM each
+  #ifndef MUX_MAX
+    #define MUX_MAX      2
+  #endif
+
+  /** @struct Switch and devices behind it */
+  typedef struct {
+    // switch address
+    uint8_t address;
+    // union of devices on all channels, upstream devices excluded
+    uint8_t devices[TWI_BITMAP_SIZE];
+  } TMux;
+
+  // steps of one switch - all channels, every channel, channels off
+  #define MUX_STEP_ALL   0
+  #define MUX_STEP_OFF   (MUX_CHANNELS + 1)
+
+  // result of step
+  #define MUX_DONE       0
+  #define MUX_MORE       1
+  #define MUX_RETRY      2
+  // channel probed - result in channel, more steps follow
+  #define MUX_CHANNEL    3
+
+  /** @struct Map of switches behind upstream segment */
+  typedef struct {
+    // number of switches
+    uint8_t count;
+    // switches
+    TMux mux[MUX_MAX];
+    // probes spent by last traversal
+    uint16_t probes;
+    // traversal - switch, step of switch, address probed next
+    // by step (0 step not started)
+    uint8_t index;
+    uint8_t step;
+    uint8_t next;
+    // last probed channel - not kept, caller sends it out
+    // before next step
+    struct {
+      uint8_t address;
+      uint8_t number;
+      uint8_t devices[TWI_BITMAP_SIZE];
+    } channel;
+  } TMuxMap;
+
+  /**
+   * @desc    Find switches on upstream segment - control register
+   *          read twice, channels off written only to devices
+   *          passing reads
+   *
+   * @param   TMuxMap *
+   * @param   const uint8_t * upstream presence bitmap
+   *
+   * @return  uint8_t number of switches
+   */
+  uint8_t MUX_Detect(TMuxMap *, const uint8_t *);
+
+  /**
+   * @desc    Start traversal of detected switches
+   *
+   * @param   TMuxMap *
+   *
+   * @return  void
+   */
+  void MUX_Begin(TMuxMap *);
+
+  /**
+   * @desc    Traversal step - all channels of switch, one channel
+   *          or channels off; step repeated after MUX_RETRY, step
+   *          interrupted after progress goes on from lost address
+   *          and returns MUX_MORE
+   *
+   * @param   TMuxMap *
+   * @param   const uint8_t * upstream presence bitmap
+   * @param   unsigned char first address
+   * @param   unsigned char last address
+   *
+   * @return  uint8_t MUX_MORE / MUX_CHANNEL / MUX_DONE / MUX_RETRY lost
+   *          arbitration, bus busy
+   */
+  uint8_t MUX_Step(TMuxMap *, const uint8_t *, unsigned char, unsigned char);
+
+  /**
+   * @desc    Step given up - its result cleared, traversal goes on
+   *
+   * @param   TMuxMap *
+   *
+   * @return  void
+   */
+  void MUX_Skip(TMuxMap *);
+
+#endif
@@ -0,0 +1,150 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        UART / interrupt driven serial output
+ * -------------------------------------------------------------+ 
+ *
+ * @file        uart.c
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+// include libraries
+#include <avr/interrupt.h>
+#include "uart.h"
+
+/** @var Transmit buffer */
+static volatile uint8_t txBuffer[UART_TX_SIZE];
+/** @var Transmit buffer write index */
+static volatile uint8_t txHead = 0;
+/** @var Transmit buffer read index */
+static volatile uint8_t txTail = 0;
+/** @var Receive buffer */
+static volatile uint8_t rxBuffer[UART_RX_SIZE];
+/** @var Receive buffer write index */
+static volatile uint8_t rxHead = 0;
+/** @var Receive buffer read index */
+static volatile uint8_t rxTail = 0;
+
+/**
+ * @desc    UART init - 8N1, transmitter and receiver
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+void UART_Init(void)
+{
+  // baud rate
+  UBRRH = (uint8_t) (UART_UBRR >> 8);
+  UBRRL = (uint8_t) UART_UBRR;
+  // transmitter, receiver and receive complete interrupt enable
+  UCSRB = (1 << TXEN) | (1 << RXEN) | (1 << RXCIE);
+  // 8 data bits, no parity, 1 stop bit
+  UCSRC = (1 << URSEL) | (1 << UCSZ1) | (1 << UCSZ0);
+  // enable interrupts
+  sei();
+}
+
+/**
+ * @desc    UART free bytes in transmit buffer
+ *
+ * @param   void
+ *
+ * @return  uint8_t
+ */
+uint8_t UART_Free(void)
+{
+  // one entry stays empty
+  return (UART_TX_SIZE - 1) - ((txHead - txTail) & (UART_TX_SIZE - 1));
+}
+
+/**
+ * @desc    UART write bytes - all or nothing, never waits
+ *
+ * @param   const uint8_t * data
+ * @param   uint8_t length
+ *
+ * @return  char
+ */
+char UART_Write(const uint8_t *data, uint8_t length)
+{
+  uint8_t head = txHead;
+
+  // check if room for all
+  if (length > UART_Free()) {
+    // try later
+    return UART_ERROR;
+  }
+  // copy to buffer
+  while (length--) {
+    txBuffer[head] = *data++;
+    head = (head + 1) & (UART_TX_SIZE - 1);
+  }
+  // publish
+  txHead = head;
+  // data register empty interrupt sends buffer
+  UCSRB |= (1 << UDRIE);
+  // success
+  return UART_SUCCESS;
+}
+
+/**
+ * @desc    UART data register empty - send next byte
+ *
+ * @param   USART_UDRE_vect
+ *
+ * @return  void
+ */
+ISR(USART_UDRE_vect)
+{
+  // check if buffer empty
+  if (txHead == txTail) {
+    // stop interrupt
+    UCSRB &= ~(1 << UDRIE);
+    return;
+  }
+  // send byte
+  UDR = txBuffer[txTail];
+  txTail = (txTail + 1) & (UART_TX_SIZE - 1);
+}
+
+/**
+ * @desc    UART read received byte - never waits
+ *
+ * @param   uint8_t * data
+ *
+ * @return  char
+ */
+char UART_Read(uint8_t *data)
+{
+  // check if buffer empty
+  if (rxHead == rxTail) {
+    // nothing received
+    return UART_ERROR;
+  }
+  // oldest byte
+  *data = rxBuffer[rxTail];
+  rxTail = (rxTail + 1) & (UART_RX_SIZE - 1);
+  // success
+  return UART_SUCCESS;
+}
+
+/**
+ * @desc    UART receive complete - store byte
+ *
+ * @param   USART_RXC_vect
+ *
+ * @return  void
+ */
+ISR(USART_RXC_vect)
+{
+  // read clears flag
+  uint8_t data = UDR;
+  uint8_t next = (rxHead + 1) & (UART_RX_SIZE - 1);
+
+  // byte dropped if buffer full
+  if (next != rxTail) {
+    rxBuffer[rxHead] = data;
+    rxHead = next;
+  }
+}
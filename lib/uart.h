@@ -0,0 +1,81 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        UART / interrupt driven serial output
+ * -------------------------------------------------------------+ 
+ *
+ * @file        uart.h
+ * @tested      AVR Atmega16
+ * -------------------------------------------------------------+ 
+ */
+
+#include <stdint.h>
+#include <avr/io.h>
+
+#ifndef __UART_H__
+#define __UART_H__
+
+  #ifndef F_CPU
+    #define F_CPU 16000000
+  #endif
+
+  // baud rate
+  #ifndef UART_BAUD
+    #define UART_BAUD 38400
+  #endif
+
+  // baud rate register - normal speed
+  #define UART_UBRR ((F_CPU / 16 / UART_BAUD) - 1)
+
+  // transmit buffer size, power of 2
+  #ifndef UART_TX_SIZE
+    #define UART_TX_SIZE 64
+  #endif
+
+  // receive buffer size, power of 2
+  #ifndef UART_RX_SIZE
+    #define UART_RX_SIZE 32
+  #endif
+
+  // success return value
+  #define UART_SUCCESS 0
+  // error return value
+  #define UART_ERROR   1
+
+  /**
+   * @desc    UART init - 8N1, transmitter and receiver
+   *
+   * @param   void
+   *
+   * @return  void
+   */
+  void UART_Init(void);
+
+  /**
+   * @desc    UART free bytes in transmit buffer
+   *
+   * @param   void
+   *
+   * @return  uint8_t
+   */
+  uint8_t UART_Free(void);
+
+  /**
+   * @desc    UART write bytes - all or nothing, never waits
+   *
+   * @param   const uint8_t * data
+   * @param   uint8_t length
+   *
+   * @return  char
+   */
+  char UART_Write(const uint8_t *, uint8_t);
+
+  /**
+   * @desc    UART read received byte - never waits
+   *
+   * @param   uint8_t * data
+   *
+   * @return  char
+   */
+  char UART_Read(uint8_t *);
+
+#endif
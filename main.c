@@ -13,8 +13,891 @@
  */
  
 // include libraries
-#include "lib/st7735.h"
+#include <string.h>
+#include "lib/display.h"
 #include "lib/twi.h"
+#include "lib/sched.h"
+#include "lib/uart.h"
+#include "lib/scanlog.h"
+#include "lib/cli.h"
+#include "lib/swi.h"
+#include "lib/twimux.h"
+#include "lib/topo.h"
+#include "lib/number.h"
+#include "lib/perf.h"
+#include "lib/prof.h"
+
+// default pause between scans in ms
+#define SCAN_PERIOD   1000
+// every n-th scan probes all addresses slowly
+#define SCAN_CALIBRATE 16
+// stats refresh in ms
+#define STATS_PERIOD  2000
+// addresses listed on one row
+#define LIST_COLS     8
+// first row of list
+#define LIST_Y        35
+// switch entries on one row
+#define MUX_COLS      4
+// row of stats
+#define STATS_Y       118
+// numbers on stats row
+#define STATS_NUMBERS 4
+// scanner screen laid out for 160x128 - SSD1306 (128x64 at most,
+// 128x32 with 512 B framebuffer on parts below 2 KB RAM) has no room
+// for list and stats row, its driver stays usable on its own
+#if DISPLAY_BACKEND == DISPLAY_SSD1306
+  #error "Scanner screen needs 160x128 display - DISPLAY_SSD1306 not supported by scanner UI"
+#endif
+// serial output mode
+#ifndef SCANLOG_MODE
+  #define SCANLOG_MODE SCANLOG_BINARY
+#endif
+// mounting of display - steps from ST7735_MADCTL
+#ifndef SCREEN_ROTATION
+  #define SCREEN_ROTATION ROTATE_0
+#endif
+// own address in slave mode
+#ifndef TWI_SL_ADDRESS
+  #define TWI_SL_ADDRESS 0x5A
+#endif
+
+/** @var Presence bitmap of last finished scan */
+uint8_t found[TWI_BITMAP_SIZE];
+/** @var Presence bitmap of scan in progress */
+uint8_t probing[TWI_BITMAP_SIZE];
+/** @var Number of finished scans */
+uint16_t scans = 0;
+/** @var Devices behind switches */
+TMuxMap muxMap;
+/** @var Switches detected after next scan - first scan, command mux */
+volatile uint8_t muxDetect = 1;
+/** @var Clock stretching per address */
+TWI_Profile profile;
+/** @var Results served to supervisor in slave mode */
+TWI_Snapshot snapshot;
+/** @var Probes ended by other than ACK / NACK in last scan */
+uint16_t scanErrors = 0;
+/** @var Contention on shared bus in last scan */
+TWI_Contention contention;
+/** @var Time stamp of last scan in ms */
+uint32_t scanTime = 0;
+/** @var Finished scan not displayed yet */
+volatile uint8_t scanDone = 0;
+/** @var Finished scan not sent yet */
+volatile uint8_t scanLogged = 1;
+/** @var Serial output mode */
+uint8_t scanLogMode = SCANLOG_MODE;
+/** @var Pause between scans in ms - core sleeps meanwhile */
+uint16_t scanPeriod = SCAN_PERIOD;
+/** @var Shown bitmap comes from EEPROM, not verified yet */
+volatile uint8_t scanCached = 0;
+/** @var Display initialized */
+volatile uint8_t displayReady = 0;
+/** @var Table of last scan requested */
+volatile uint8_t scanDump = 0;
+#ifdef PROFILE
+/** @var Profile dump requested */
+volatile uint8_t profDump = 0;
+#endif
+/** @var Scan of software buses, stepped by command task */
+SWI_ScanState swiScan;
+/** @var Scan of software buses requested */
+uint8_t swiRunning = 0;
+/** @var First scanned address */
+unsigned char scanFirst = TWI_ADDR_FIRST;
+/** @var Last scanned address */
+unsigned char scanLast = TWI_ADDR_LAST;
+
+/** @var Tasks */
+TTask scanTask;
+TTask displayTask;
+TTask statsTask;
+TTask serialTask;
+TTask commandTask;
+#ifdef PROFILE
+TTask profTask;
+#endif
+
+/**
+ * @desc    Scan task - one address per run
+ *
+ * @param   TTask *
+ *
+ * @return  char
+ */
+char ScanTask(TTask *task)
+{
+  static unsigned char address;
+  static unsigned char attempt;
+  static uint16_t start;
+  unsigned char status;
+  TTopology topo;
+
+  TASK_BEGIN(task);
+  // forever
+  while (1) {
+    // cached topology verified after display shows it - verify scan
+    // would end within display init and replace cached screen
+    TASK_WAIT_UNTIL(task, !scanCached || (displayReady && !scanDone));
+    // clear bitmap
+    memset(probing, 0, TWI_BITMAP_SIZE);
+    snapshot.acks = 0;
+    snapshot.nacks = 0;
+    scanErrors = 0;
+    memset(&contention, 0, sizeof(contention));
+    start = SchedTicks();
+    // loop through addresses
+    for (address = scanFirst; address <= scanLast; address++) {
+      // own slave address is not probed
+      if (address == TWI_SL_ADDRESS) {
+        continue;
+      }
+      // cached topology - only cached addresses are probed
+      if (scanCached && !(found[address >> 3] & (1 << (address & 0x07)))) {
+        continue;
+      }
+      // repeat probe lost in arbitration or not started on busy bus,
+      // scan continues at same address
+      attempt = 0;
+      while (1) {
+        // probe
+        status = TWI_MT_ProbeAdaptive(&profile, address, (scans % SCAN_CALIBRATE) == 0);
+        // check if other master won or holds bus
+        if ((TWI_FLAG_ARB_LOST != status) && (TWI_BUS_BUSY != status)) {
+          break;
+        }
+        if (TWI_FLAG_ARB_LOST == status) {
+          contention.arbLost++;
+        }
+        // check if retries left
+        if (++attempt > TWI_ARB_RETRIES) {
+          contention.giveUps++;
+          break;
+        }
+        contention.retries++;
+        // random backoff
+        TASK_DELAY(task, TWI_Backoff(attempt));
+      }
+      // check if device acknowledged
+      if (TWI_MT_SLAW_ACK == status) {
+        // set bit
+        probing[address >> 3] |= (1 << (address & 0x07));
+        snapshot.acks++;
+      } else if (TWI_MT_SLAW_NACK == status) {
+        snapshot.nacks++;
+      } else {
+        // bus error or address given up
+        if ((TWI_FLAG_ARB_LOST != status) && (TWI_BUS_BUSY != status)) {
+          contention.busErrors++;
+        }
+        scanErrors++;
+      }
+      // let other tasks run
+      TASK_YIELD(task);
+    }
+    // cached topology verified
+    if (scanCached) {
+      scanCached = 0;
+      // cached device missing - full scan at once
+      if (memcmp(probing, found, TWI_BITMAP_SIZE) != 0) {
+        continue;
+      }
+    } else {
+      // remember for next power on - once stable, written during pause
+      memcpy(topo.bitmap, probing, TWI_BITMAP_SIZE);
+      memcpy(topo.slow, profile.slow, TWI_BITMAP_SIZE);
+      topo.twbr = TWI_TWBR;
+      topo.twsr = TWI_TWSR & 0x03;
+      TOPO_Save(&topo);
+    }
+    // switches found by control register - once, again on command
+    if (muxDetect) {
+      muxDetect = 0;
+      MUX_Detect(&muxMap, probing);
+    }
+    // devices behind switches - one step per run, step goes on
+    // from address lost in arbitration
+    MUX_Begin(&muxMap);
+    attempt = 0;
+    while (MUX_DONE != (status = MUX_Step(&muxMap, probing, scanFirst, scanLast))) {
+      if (MUX_RETRY == status) {
+        // check if retries left
+        if (++attempt > TWI_ARB_RETRIES) {
+          contention.giveUps++;
+          MUX_Skip(&muxMap);
+          attempt = 0;
+        } else {
+          contention.retries++;
+          // random backoff
+          TASK_DELAY(task, TWI_Backoff(attempt));
+          continue;
+        }
+      } else {
+        attempt = 0;
+        // devices of channel - sent out, not kept in map
+        if (MUX_CHANNEL == status) {
+          TASK_WAIT_UNTIL(task, (SCANLOG_OFF == scanLogMode) ||
+            (UART_SUCCESS == ScanLogChannel(muxMap.channel.address, muxMap.channel.number,
+                                            muxMap.channel.devices, scanLogMode)));
+        }
+      }
+      // let other tasks run
+      TASK_YIELD(task);
+    }
+    // publish result
+    memcpy(found, probing, TWI_BITMAP_SIZE);
+    scans++;
+    // ms counter of tick, stamp in timer counts wraps after ~4.77 h
+    scanTime = SchedMillis();
+    scanDone = 1;
+    scanLogged = 0;
+    // publish for supervisor
+    memcpy(snapshot.bitmap, probing, TWI_BITMAP_SIZE);
+    snapshot.scans = scans;
+    snapshot.time = SchedTicks() - start;
+    snapshot.arbLost = contention.arbLost;
+    snapshot.giveUps = contention.giveUps;
+    TASK_WAIT_UNTIL(task, SUCCESS == TWI_SL_Publish(&snapshot));
+    // pause - cached topology written one byte per run meanwhile,
+    // EEPROM write (~8.5 ms per byte) never blocks other tasks
+    task->wake = SchedTicks() + scanPeriod;
+    while (TOPO_BUSY == TOPO_Step()) {
+      TASK_YIELD(task);
+    }
+    TASK_WAIT_UNTIL(task, SchedExpired(task->wake));
+  }
+  TASK_END(task);
+}
+
+/**
+ * @desc    Display task - list of found devices
+ *
+ * @param   TTask *
+ *
+ * @return  char
+ */
+char DisplayTask(TTask *task)
+{
+  static unsigned char address;
+  static unsigned char count;
+  static unsigned char entry;
+  static uint8_t mux;
+  static uint8_t y;
+  static uint8_t cached;
+  uint16_t time;
+  char msg[20];
+
+  TASK_BEGIN(task);
+  // display bring up, scan runs during delays
+  while ((time = DisplayInitStep()) != DISPLAY_INIT_DONE) {
+    TASK_DELAY(task, time);
+  }
+  // mounting
+  SetRotation(SCREEN_ROTATION);
+  // clear screen
+  ClearScreen(BLACK);
+  // set position x, y
+  SetPosition(25, 5);
+  // draw string from flash
+  strcpy_P(msg, PSTR("TWI / I2C SCANNER"));
+  DrawString(msg, WHITE, X1);
+  // update screen
+  UpdateScreen();
+  displayReady = 1;
+  // forever
+  while (1) {
+    // wait for finished scan
+    TASK_WAIT_UNTIL(task, scanDone);
+    scanDone = 0;
+    // label of drawn list - verify scan runs meanwhile
+    cached = scanCached;
+    // clear list area
+    DrawRectangle(0, SIZE_X, LIST_Y - 15, STATS_Y - 2, BLACK);
+    TASK_YIELD(task);
+    count = 0;
+    // loop through found addresses
+    for (address = TWI_ADDR_FIRST; address <= TWI_ADDR_LAST; address++) {
+      // check if found
+      if (found[address >> 3] & (1 << (address & 0x07))) {
+        // position in list
+        SetPosition(2 + (count % LIST_COLS) * 20, LIST_Y + (count / LIST_COLS) * 10);
+        // to string
+        NumberFormat(msg, address, 16, 2, '0');
+        // draw string
+        DrawString(msg, WHITE, X1);
+        count++;
+        // one address per run
+        TASK_YIELD(task);
+      }
+    }
+    // devices behind switches - below upstream list, channels
+    // of devices go out over serial only
+    entry = 0;
+    y = LIST_Y + ((count + LIST_COLS - 1) / LIST_COLS) * 10;
+    for (mux = 0; mux < muxMap.count; mux++) {
+      for (address = TWI_ADDR_FIRST; address <= TWI_ADDR_LAST; address++) {
+        // check if found and room on screen
+        if ((muxMap.mux[mux].devices[address >> 3] & (1 << (address & 0x07))) &&
+            ((y + (entry / MUX_COLS) * 10) < (STATS_Y - 10))) {
+          // position in list
+          SetPosition(2 + (entry % MUX_COLS) * 40, y + (entry / MUX_COLS) * 10);
+          // switch:address
+          NumberFormat(msg, muxMap.mux[mux].address, 16, 2, '0');
+          msg[2] = ':';
+          NumberFormat(msg + 3, address, 16, 2, '0');
+          // draw string
+          DrawString(msg, WHITE, X1);
+          entry++;
+          count++;
+          // one address per run
+          TASK_YIELD(task);
+        }
+      }
+    }
+    // set position x, y
+    SetPosition(18, 20);
+    // to string
+    strcpy_P(msg, cached ? PSTR("Devices cached: ") : PSTR("Devices found: "));
+    NumberFormat(msg + strlen(msg), count, 10, 0, ' ');
+    // draw string
+    DrawString(msg, cached ? WHITE : RED, X1);
+    // framebuffer backends send changes
+    UpdateScreen();
+  }
+  TASK_END(task);
+}
+
+/**
+ * @desc    Serial task - scan records to UART
+ *
+ * @param   TTask *
+ *
+ * @return  char
+ */
+char SerialTask(TTask *task)
+{
+  static uint8_t row;
+  static uint8_t mode;
+
+  TASK_BEGIN(task);
+  // forever
+  while (1) {
+    // wait for finished scan or dump request
+    TASK_WAIT_UNTIL(task, !scanLogged || scanDump);
+    // dump is always table
+    mode = scanDump ? SCANLOG_TEXT : scanLogMode;
+    // binary frame
+    if (mode == SCANLOG_BINARY) {
+      // wait for room in buffer
+      TASK_WAIT_UNTIL(task, UART_SUCCESS == ScanLogBinary(scans, scanTime, found, scanErrors));
+    // i2cdetect like table
+    } else if (mode == SCANLOG_TEXT) {
+      // loop through rows
+      for (row = 0; row < SCANLOG_ROWS; row++) {
+        // wait for room in buffer
+        TASK_WAIT_UNTIL(task, UART_SUCCESS == ScanLogTextRow(found, row));
+      }
+    }
+    // check if dump done
+    if (scanDump) {
+      scanDump = 0;
+    } else {
+      scanLogged = 1;
+    }
+  }
+  TASK_END(task);
+}
+
+/**
+ * @desc    Command scan <first> <last> - scanned range
+ *
+ * @param   uint8_t argc
+ * @param   char ** argv
+ * @param   char * reply
+ *
+ * @return  char
+ */
+char CommandScan(uint8_t argc, char **argv, char *reply)
+{
+  uint16_t first, last;
+
+  // check range
+  if ((CLI_Number(argv[0], &first) != CLI_SUCCESS) ||
+      (CLI_Number(argv[1], &last) != CLI_SUCCESS) ||
+      (first > last) || (last > 0x7F)) {
+    return CLI_ERROR;
+  }
+  // applied from next scan
+  scanFirst = first;
+  scanLast = last;
+  return CLI_SUCCESS;
+}
+
+/**
+ * @desc    Command speed <kHz> - bus speed
+ *
+ * @param   uint8_t argc
+ * @param   char ** argv
+ * @param   char * reply
+ *
+ * @return  char
+ */
+char CommandSpeed(uint8_t argc, char **argv, char *reply)
+{
+  uint16_t khz;
+
+  // check speed
+  if ((CLI_Number(argv[0], &khz) != CLI_SUCCESS) ||
+      (TWI_SetSpeed(khz) != SUCCESS)) {
+    return CLI_ERROR;
+  }
+  return CLI_SUCCESS;
+}
+
+/**
+ * @desc    Command rd <addr> <reg> - read register
+ *
+ * @param   uint8_t argc
+ * @param   char ** argv
+ * @param   char * reply
+ *
+ * @return  char
+ */
+char CommandRead(uint8_t argc, char **argv, char *reply)
+{
+  uint16_t address, reg;
+  unsigned char value;
+
+  // check arguments and read
+  if ((CLI_Number(argv[0], &address) != CLI_SUCCESS) || (address > 0x7F) ||
+      (CLI_Number(argv[1], &reg) != CLI_SUCCESS) || (reg > 0xFF) ||
+      (TWI_MR_ReadReg(address, reg, &value) != SUCCESS)) {
+    return CLI_ERROR;
+  }
+  // value
+  NumberFormat(reply, value, 16, 2, '0');
+  return CLI_SUCCESS;
+}
+
+/**
+ * @desc    Command wr <addr> <reg> <value> - write register
+ *
+ * @param   uint8_t argc
+ * @param   char ** argv
+ * @param   char * reply
+ *
+ * @return  char
+ */
+char CommandWrite(uint8_t argc, char **argv, char *reply)
+{
+  uint16_t address, reg, value;
+
+  // check arguments and write
+  if ((CLI_Number(argv[0], &address) != CLI_SUCCESS) || (address > 0x7F) ||
+      (CLI_Number(argv[1], &reg) != CLI_SUCCESS) || (reg > 0xFF) ||
+      (CLI_Number(argv[2], &value) != CLI_SUCCESS) || (value > 0xFF) ||
+      (TWI_MT_WriteReg(address, reg, value) != SUCCESS)) {
+    return CLI_ERROR;
+  }
+  return CLI_SUCCESS;
+}
+
+/**
+ * @desc    Command dump - table of last scan
+ *
+ * @param   uint8_t argc
+ * @param   char ** argv
+ * @param   char * reply
+ *
+ * @return  char
+ */
+char CommandDump(uint8_t argc, char **argv, char *reply)
+{
+  // serial task sends table
+  scanDump = 1;
+  return CLI_SUCCESS;
+}
+
+/**
+ * @desc    Command monitor on|off|text - output of every scan
+ *
+ * @param   uint8_t argc
+ * @param   char ** argv
+ * @param   char * reply
+ *
+ * @return  char
+ */
+char CommandMonitor(uint8_t argc, char **argv, char *reply)
+{
+  // binary frames
+  if (strcmp_P(argv[0], PSTR("on")) == 0) {
+    scanLogMode = SCANLOG_BINARY;
+  // table
+  } else if (strcmp_P(argv[0], PSTR("text")) == 0) {
+    scanLogMode = SCANLOG_TEXT;
+  // nothing
+  } else if (strcmp_P(argv[0], PSTR("off")) == 0) {
+    scanLogMode = SCANLOG_OFF;
+  } else {
+    return CLI_ERROR;
+  }
+  return CLI_SUCCESS;
+}
+
+/**
+ * @desc    Command mux - switches detected again after next scan
+ *
+ * @param   uint8_t argc
+ * @param   char ** argv
+ * @param   char * reply
+ *
+ * @return  char
+ */
+char CommandMux(uint8_t argc, char **argv, char *reply)
+{
+  // after scan in progress
+  muxDetect = 1;
+  return CLI_SUCCESS;
+}
+
+/**
+ * @desc    Command swi - scan software buses in parallel, one
+ *          address per pass of command task, reply when done
+ *
+ * @param   uint8_t argc
+ * @param   char ** argv
+ * @param   char * reply
+ *
+ * @return  char
+ */
+char CommandSwi(uint8_t argc, char **argv, char *reply)
+{
+  // all buses in one pass
+  SWI_ScanBegin(&swiScan, scanFirst, scanLast);
+  swiRunning = 1;
+  return CLI_SUCCESS;
+}
+
+/**
+ * @desc    Reply of finished swi scan - devices per bus
+ *
+ * @param   char * reply CLI_REPLY_SIZE
+ *
+ * @return  uint8_t length
+ */
+uint8_t SwiReply(char *reply)
+{
+  uint8_t bus, i, count;
+  uint8_t length = 0;
+
+  // number of devices per bus
+  for (bus = 0; bus < SWI_BUSES; bus++) {
+    count = 0;
+    for (i = 0; i < 128; i++) {
+      if (swiScan.bitmaps[bus][i >> 3] & (1 << (i & 0x07))) {
+        count++;
+      }
+    }
+    reply[length++] = 'b';
+    reply[length++] = '0' + bus;
+    reply[length++] = ':';
+    length += NumberFormat(reply + length, count, 10, 0, ' ');
+    reply[length++] = ' ';
+  }
+  // end of line
+  reply[length++] = '\r';
+  reply[length++] = '\n';
+  return length;
+}
+
+/**
+ * @desc    Command lat <addr> - clock stretching of address
+ *
+ * @param   uint8_t argc
+ * @param   char ** argv
+ * @param   char * reply
+ *
+ * @return  char
+ */
+char CommandLatency(uint8_t argc, char **argv, char *reply)
+{
+  uint16_t address;
+
+  // check argument
+  if ((CLI_Number(argv[0], &address) != CLI_SUCCESS) || (address > 0x7F)) {
+    return CLI_ERROR;
+  }
+  // stretch in us, slow flag
+  reply += NumberFormat(reply, profile.stretch[address] * TWI_STRETCH_UNIT_US, 10, 0, ' ');
+  strcpy_P(reply, (profile.slow[address >> 3] & (1 << (address & 0x07))) ? PSTR("us slow") : PSTR("us"));
+  return CLI_SUCCESS;
+}
+
+#ifdef PERF_COUNTERS
+/**
+ * @desc    Command perf <counter>|reset - driver counters (lib/perf.h)
+ *
+ * @param   uint8_t argc
+ * @param   char ** argv
+ * @param   char * reply
+ *
+ * @return  char
+ */
+char CommandPerf(uint8_t argc, char **argv, char *reply)
+{
+  TPerf snapshot;
+  uint8_t i;
+
+  // clear all
+  if (strcmp_P(argv[0], PSTR("reset")) == 0) {
+    PerfReset();
+    return CLI_SUCCESS;
+  }
+  // counter by name
+  for (i = 0; i < PERF_SIZE; i++) {
+    if (strcmp_P(argv[0], PerfName(i)) == 0) {
+      PerfSnapshot(&snapshot);
+      NumberFormat(reply, PerfGet(&snapshot, i), 10, 0, ' ');
+      return CLI_SUCCESS;
+    }
+  }
+  return CLI_ERROR;
+}
+#endif
+
+#ifdef PROFILE
+/**
+ * @desc    Command prof on [<start> <shift>]|off|dump - sampling profiler (lib/prof.h)
+ *
+ * @param   uint8_t argc
+ * @param   char ** argv
+ * @param   char * reply
+ *
+ * @return  char
+ */
+char CommandProf(uint8_t argc, char **argv, char *reply)
+{
+  uint16_t start = PROFILE_START;
+  uint16_t shift = PROFILE_SHIFT;
+
+  // clear and sample, optional window
+  if (strcmp_P(argv[0], PSTR("on")) == 0) {
+    if (((argc > 1) && (CLI_Number(argv[1], &start) != CLI_SUCCESS)) ||
+        ((argc > 2) && (CLI_Number(argv[2], &shift) != CLI_SUCCESS)) ||
+        (shift > 15)) {
+      return CLI_ERROR;
+    }
+    ProfStart(start, shift);
+  // histogram kept
+  } else if (strcmp_P(argv[0], PSTR("off")) == 0) {
+    ProfStop();
+  // profile task sends histogram
+  } else if (strcmp_P(argv[0], PSTR("dump")) == 0) {
+    profDump = 1;
+  } else {
+    return CLI_ERROR;
+  }
+  return CLI_SUCCESS;
+}
+#endif
+
+/**
+ * @desc    Command period <ms> - pause between scans, duty cycle,
+ *          10 - 32767 ms
+ *
+ * @param   uint8_t argc
+ * @param   char ** argv
+ * @param   char * reply
+ *
+ * @return  char
+ */
+char CommandPeriod(uint8_t argc, char **argv, char *reply)
+{
+  uint16_t period;
+
+  // check argument
+  if ((CLI_Number(argv[0], &period) != CLI_SUCCESS) || (period < 10) || (period > SCHED_DELAY_MAX)) {
+    return CLI_ERROR;
+  }
+  // from next pause
+  scanPeriod = period;
+  return CLI_SUCCESS;
+}
+
+/** @def Optional commands */
+#ifdef PERF_COUNTERS
+  #define COMMANDS_PERF(C) C(perf, 1, CommandPerf)
+#else
+  #define COMMANDS_PERF(C)
+#endif
+#ifdef PROFILE
+  #define COMMANDS_PROF(C) C(prof, 1, CommandProf)
+#else
+  #define COMMANDS_PROF(C)
+#endif
+
+/** @def Commands - C(name, min number of arguments, handler) */
+#define COMMANDS_LIST(C) \
+  C(scan,    2, CommandScan) \
+  C(speed,   1, CommandSpeed) \
+  C(rd,      2, CommandRead) \
+  C(wr,      3, CommandWrite) \
+  C(dump,    0, CommandDump) \
+  C(monitor, 1, CommandMonitor) \
+  C(swi,     0, CommandSwi) \
+  C(mux,     0, CommandMux) \
+  C(lat,     1, CommandLatency) \
+  C(period,  1, CommandPeriod) \
+  COMMANDS_PERF(C) \
+  COMMANDS_PROF(C)
+
+/** @def Name of command in flash */
+#define COMMAND_NAME(name, args, handler) static const char COMMAND_##name[] PROGMEM = #name;
+/** @def Entry of command table */
+#define COMMAND_ENTRY(name, args, handler) { COMMAND_##name, args, handler },
+
+// names
+COMMANDS_LIST(COMMAND_NAME)
+
+/** @array Commands in flash */
+const TCliCommand COMMANDS[] PROGMEM = {
+  COMMANDS_LIST(COMMAND_ENTRY)
+  { NULL,      0, NULL }
+};
+
+/**
+ * @desc    Feed received bytes to interpreter
+ *
+ * @param   void
+ *
+ * @return  char
+ */
+char LineReceived(void)
+{
+  uint8_t c;
+
+  // loop through received bytes
+  while (UART_Read(&c) == UART_SUCCESS) {
+    // check if line complete
+    if (CLI_Feed(c) == CLI_LINE) {
+      return 1;
+    }
+  }
+  // wait for more
+  return 0;
+}
+
+/**
+ * @desc    Command task - lines from UART
+ *
+ * @param   TTask *
+ *
+ * @return  char
+ */
+char CommandTask(TTask *task)
+{
+  static char reply[CLI_REPLY_SIZE];
+  static uint8_t length;
+
+  TASK_BEGIN(task);
+  // forever
+  while (1) {
+    // wait for line
+    TASK_WAIT_UNTIL(task, LineReceived());
+    // execute
+    length = CLI_Execute(reply);
+    // software buses - one address per pass, counts replace ok
+    if (swiRunning) {
+      while (SWI_ScanStep(&swiScan)) {
+        TASK_YIELD(task);
+      }
+      swiRunning = 0;
+      length = SwiReply(reply);
+    }
+    // wait for room in buffer
+    TASK_WAIT_UNTIL(task, UART_SUCCESS == UART_Write((const uint8_t *) reply, length));
+  }
+  TASK_END(task);
+}
+
+#ifdef PROFILE
+/**
+ * @desc    Profile task - histogram as text lines
+ *
+ * @param   TTask *
+ *
+ * @return  char
+ */
+char ProfTask(TTask *task)
+{
+  static char line[PROFILE_LINE_SIZE];
+  static uint8_t index;
+  static uint8_t length;
+
+  TASK_BEGIN(task);
+  // forever
+  while (1) {
+    // wait for dump request
+    TASK_WAIT_UNTIL(task, profDump);
+    // loop through lines, empty bins skipped
+    for (index = 0; index < PROFILE_LINES; index++) {
+      length = ProfLine(line, index);
+      // wait for room in buffer
+      TASK_WAIT_UNTIL(task, !length || (UART_SUCCESS == UART_Write((const uint8_t *) line, length)));
+    }
+    profDump = 0;
+  }
+  TASK_END(task);
+}
+#endif
+
+/**
+ * @desc    Stats task - share of time spent in tasks
+ *
+ * @param   TTask *
+ *
+ * @return  char
+ */
+char StatsTask(TTask *task)
+{
+  static TNumber numbers[STATS_NUMBERS];
+  char label[20];
+  uint32_t total;
+  uint8_t i;
+  uint16_t value;
+
+  TASK_BEGIN(task);
+  // display initialized by display task
+  TASK_WAIT_UNTIL(task, displayReady);
+  // labels once - scan, display and sleeping core share, scans
+  SetPosition(2, STATS_Y);
+  strcpy_P(label, PSTR("S:  % D:  % Z:  % #"));
+  DrawStringOpaque(label, WHITE, BLACK, X1);
+  // numbers - cell after label
+  for (i = 0; i < STATS_NUMBERS - 1; i++) {
+    NumberInit(&numbers[i], 2 + (2 + i * 6) * (CHARS_COLS_LEN + 1), STATS_Y, 2, 10, WHITE, BLACK);
+  }
+  NumberInit(&numbers[i], 2 + 19 * (CHARS_COLS_LEN + 1), STATS_Y, 5, 10, WHITE, BLACK);
+  // forever
+  while (1) {
+    // period
+    TASK_DELAY(task, STATS_PERIOD);
+    // measured time - serial, command and profiler tasks included
+    total = SchedRuntime() + 1;
+    // shares in percent, only changed digits drawn
+    for (i = 0; i < STATS_NUMBERS - 1; i++) {
+      value = ((i == 0) ? scanTask.runtime : (i == 1) ? displayTask.runtime : SchedSleep()) * 100 / total;
+      NumberDraw(&numbers[i], (value > 99) ? 99 : value);
+    }
+    NumberDraw(&numbers[i], scans);
+    // framebuffer backends send changes
+    UpdateScreen();
+    // next period
+    SchedResetStats();
+  }
+  TASK_END(task);
+}
 
 /**
  * @desc    Main
@@ -25,37 +908,55 @@
  */
 int main(void)
 {
-  unsigned char found;
-  char msg[20];
+  TTopology topo;
 
-  // DISPLAY ST7735
+  // Scheduler - enables interrupts
   // -------------------------------------------------   
-  St7735Init();
-  // clear screen
-  ClearScreen(BLACK);
+  SchedInit();
 
   // Init TWI
   // -------------------------------------------------------
   TWI_Init();
+  // clock stretching measure
+  TWI_TimerInit();
+  // backoff differs between masters
+  TWI_Seed(SchedStamp() ^ (TWI_SL_ADDRESS << 8));
+  // last topology - shown at once, verified by first scan
+  if (TOPO_SUCCESS == TOPO_Load(&topo)) {
+    memcpy(found, topo.bitmap, TWI_BITMAP_SIZE);
+    memcpy(profile.slow, topo.slow, TWI_BITMAP_SIZE);
+    TWI_TWBR = topo.twbr;
+    TWI_TWSR = (TWI_TWSR & ~0x03) | topo.twsr;
+    scanCached = 1;
+    scanDone = 1;
+  }
+  // answer supervisor queries
+  TWI_SL_Init(TWI_SL_ADDRESS);
 
-  // set position x, y
-  SetPosition(25, 5);
-  // draw string
-  DrawString("TWI / I2C SCANNER", WHITE, X1);
-  // find device address
-  found = TWI_MT_FindDevice();
-  // set position x, y
-  SetPosition(18, 20);
-  // draw string
-  DrawString("Device found at [", RED, X1);
-  // to string
-  sprintf(msg, "%x", found);
-  // draw string
-  DrawString(msg, WHITE, X1);
-  // draw string
-  DrawString("]", RED, X1);
-  // update screen
-  UpdateScreen();
+  // Init UART
+  // -------------------------------------------------------
+  UART_Init();
+  // commands
+  CLI_Init(COMMANDS);
+  // software buses
+  SWI_Init();
+#ifdef PROFILE
+  // sampling starts by command
+  ProfInit();
+#endif
+
+  // Tasks
+  // -------------------------------------------------------
+  SchedAdd(&scanTask, ScanTask, PSTR("scan"));
+  SchedAdd(&displayTask, DisplayTask, PSTR("display"));
+  SchedAdd(&statsTask, StatsTask, PSTR("stats"));
+  SchedAdd(&serialTask, SerialTask, PSTR("serial"));
+  SchedAdd(&commandTask, CommandTask, PSTR("command"));
+#ifdef PROFILE
+  SchedAdd(&profTask, ProfTask, PSTR("prof"));
+#endif
+  // run forever
+  SchedRun();
 
   // return value
   return 0;
@@ -0,0 +1,216 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Host check of command line interpreter (lib/cli.c)
+ * -------------------------------------------------------------+
+ *
+ * @file        clibench.c
+ * @build       cc -O2 -Ilib -o clibench tools/clibench.c lib/cli.c
+ * @usage       clibench [-c file] [-r repeats] < lines
+ *                -c  compare replies with file, exit status 1 if
+ *                    any byte differs
+ *                -r  input fed repeats times, replies dropped, prints
+ *                    lines and characters per second of host time
+ *              every received character goes through CLI_Feed, every
+ *              complete line through CLI_Execute with table of stub
+ *              handlers in PROGMEM layout of main.c; replies with
+ *              their CR LF to stdout
+ * -------------------------------------------------------------+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cli.h"
+
+// max input
+#define INPUT_SIZE (1 << 16)
+
+/**
+ * @desc    Stub - arguments echoed
+ *
+ * @param   uint8_t argc
+ * @param   char ** argv
+ * @param   char * reply
+ * @return  char
+ */
+static char CommandEcho(uint8_t argc, char **argv, char *reply)
+{
+  uint8_t i;
+  int length = 0;
+
+  for (i = 0; i < argc; i++) {
+    length += snprintf(reply + length, CLI_REPLY_SIZE - 2 - length, "%s%s", i ? " " : "", argv[i]);
+  }
+  return CLI_SUCCESS;
+}
+
+/**
+ * @desc    Stub - numbers parsed as commands of main.c do, sum
+ *          in decimal
+ *
+ * @param   uint8_t argc
+ * @param   char ** argv
+ * @param   char * reply
+ * @return  char
+ */
+static char CommandSum(uint8_t argc, char **argv, char *reply)
+{
+  uint16_t value;
+  unsigned long sum = 0;
+  uint8_t i;
+
+  for (i = 0; i < argc; i++) {
+    if (CLI_Number(argv[i], &value) != CLI_SUCCESS) {
+      return CLI_ERROR;
+    }
+    sum += value;
+  }
+  snprintf(reply, CLI_REPLY_SIZE - 2, "%lu", sum);
+  return CLI_SUCCESS;
+}
+
+/**
+ * @desc    Stub - no reply text
+ *
+ * @param   uint8_t argc
+ * @param   char ** argv
+ * @param   char * reply
+ * @return  char
+ */
+static char CommandNop(uint8_t argc, char **argv, char *reply)
+{
+  (void) argc;
+  (void) argv;
+  (void) reply;
+  return CLI_SUCCESS;
+}
+
+/**
+ * @desc    Stub - fails without reply text
+ *
+ * @param   uint8_t argc
+ * @param   char ** argv
+ * @param   char * reply
+ * @return  char
+ */
+static char CommandFail(uint8_t argc, char **argv, char *reply)
+{
+  (void) argc;
+  (void) argv;
+  (void) reply;
+  return CLI_ERROR;
+}
+
+/** @def Commands - C(name, min number of arguments, handler) */
+#define COMMANDS_LIST(C) \
+  C(echo, 0, CommandEcho) \
+  C(sum,  1, CommandSum) \
+  C(nop,  0, CommandNop) \
+  C(fail, 0, CommandFail) \
+  C(wr,   3, CommandEcho)
+
+/** @def Name of command in flash */
+#define COMMAND_NAME(name, args, handler) static const char COMMAND_##name[] PROGMEM = #name;
+/** @def Entry of command table */
+#define COMMAND_ENTRY(name, args, handler) { COMMAND_##name, args, handler },
+
+// names
+COMMANDS_LIST(COMMAND_NAME)
+
+/** @array Commands in flash */
+static const TCliCommand COMMANDS[] PROGMEM = {
+  COMMANDS_LIST(COMMAND_ENTRY)
+  { NULL, 0, NULL }
+};
+
+/**
+ * @desc    Feed input, execute complete lines
+ *
+ * @param   const char * input
+ * @param   size_t length
+ * @param   FILE * replies, NULL dropped
+ * @param   unsigned long * lines executed
+ * @return  void
+ */
+static void Run(const char *input, size_t length, FILE *out, unsigned long *lines)
+{
+  char reply[CLI_REPLY_SIZE];
+  uint8_t size;
+  size_t i;
+
+  for (i = 0; i < length; i++) {
+    if (CLI_Feed(input[i]) == CLI_LINE) {
+      size = CLI_Execute(reply);
+      (*lines)++;
+      if (out) {
+        fwrite(reply, 1, size, out);
+      }
+    }
+  }
+}
+
+/**
+ * @desc    Main
+ *
+ * @param   int argc
+ * @param   char ** argv
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+  static char input[INPUT_SIZE];
+  static char output[INPUT_SIZE * 4];
+  static char expect[INPUT_SIZE * 4];
+  const char *compare = NULL;
+  unsigned long repeats = 0, lines = 0, r;
+  size_t length, size, expected;
+  double seconds;
+  clock_t start;
+  FILE *out, *file;
+  int i;
+
+  for (i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-c") && (i + 1 < argc)) {
+      compare = argv[++i];
+    } else if (!strcmp(argv[i], "-r") && (i + 1 < argc) && ((repeats = strtoul(argv[++i], NULL, 10)) > 0)) {
+      continue;
+    } else {
+      fprintf(stderr, "usage: clibench [-c file] [-r repeats] < lines\n");
+      return 2;
+    }
+  }
+  length = fread(input, 1, sizeof(input), stdin);
+  CLI_Init(COMMANDS);
+
+  // throughput - replies dropped
+  if (repeats) {
+    start = clock();
+    for (r = 0; r < repeats; r++) {
+      Run(input, length, NULL, &lines);
+    }
+    seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    printf("lines %lu, chars %lu, %.0f lines/s, %.0f chars/s, %.0f ns / line (host)\n",
+      lines, (unsigned long) (length * repeats), lines / seconds, length * repeats / seconds,
+      1e9 * seconds / lines);
+    return 0;
+  }
+  // replies
+  if (!compare) {
+    Run(input, length, stdout, &lines);
+    return 0;
+  }
+  out = fmemopen(output, sizeof(output), "w");
+  Run(input, length, out, &lines);
+  size = ftell(out);
+  fclose(out);
+  if ((file = fopen(compare, "rb")) == NULL) {
+    perror(compare);
+    return 1;
+  }
+  expected = fread(expect, 1, sizeof(expect), file);
+  fclose(file);
+  printf("lines %lu, reply bytes %lu: %s\n", lines, (unsigned long) size,
+    ((size == expected) && !memcmp(output, expect, size)) ? "match" : "DIFFER");
+  return ((size == expected) && !memcmp(output, expect, size)) ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Host model of active and sleeping core per scan
+ * -------------------------------------------------------------+
+ *
+ * @file        dutybench.c
+ * @build       cc -O2 -Ilib -o dutybench tools/dutybench.c lib/twi.c
+ *                lib/hosttwi.c -lm
+ * @usage       dutybench [-a mA] [-i mA]
+ *                -a  supply current of active core (default 13)
+ *                -i  supply current in idle sleep (default 6)
+ *              scan 0x08 - 0x77 timed by probes of twi.c on host
+ *              model of bus, TWINT waits busy; display redraw, 1 ms
+ *              tick and stats row added as cycle estimates; for
+ *              pauses between scans (period command) prints active and
+ *              sleeping cycles per scan and mean supply current
+ * -------------------------------------------------------------+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "twi.h"
+
+// core clock
+#define FCPU_MHZ       16.0
+// scheduler pass between probes - yield, tasks checked
+#define PASS_CYCLES    150.0
+// tick interrupt and scheduler pass waking sleeping core
+#define TICK_CYCLES    150.0
+// list redraw - bytes of scanner screen (uibench screen) at
+// 16 cycles per byte, fosc / 2
+#define DISPLAY_CYCLES (4923.0 * 16.0)
+// stats row - changed digits every STATS_PERIOD
+#define STATS_CYCLES   8000.0
+#define STATS_MS       2000.0
+
+/** @array Devices of model */
+static const uint8_t DEVICES[] = { 0x20, 0x3C, 0x50, 0x68, 0x76 };
+
+/**
+ * @desc    Main
+ *
+ * @param   int argc
+ * @param   char ** argv
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+  static const unsigned PERIODS[] = { 10, 100, 1000, 10000, 32767 };
+  double active = 13, idle = 6;
+  double scan, busy, total, share;
+  unsigned char address;
+  unsigned i;
+
+  // arguments
+  for (i = 1; i < (unsigned) argc; i++) {
+    if (!strcmp(argv[i], "-a") && (i + 1 < (unsigned) argc)) {
+      active = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "-i") && (i + 1 < (unsigned) argc)) {
+      idle = atof(argv[++i]);
+    } else {
+      fprintf(stderr, "usage: dutybench [-a mA] [-i mA]\n");
+      return 2;
+    }
+  }
+  for (i = 0; i < sizeof(DEVICES); i++) {
+    HostTwiDevice(DEVICES[i]);
+  }
+  TWI_Init();
+  TWI_TimerInit();
+
+  // scan - bus time of probes, core waits busy
+  scan = hostTwiTime;
+  for (address = TWI_ADDR_FIRST; address <= TWI_ADDR_LAST; address++) {
+    TWI_MT_Probe(address);
+  }
+  scan = (hostTwiTime - scan) * FCPU_MHZ;
+  busy = scan + (TWI_ADDR_LAST - TWI_ADDR_FIRST + 1) * PASS_CYCLES + DISPLAY_CYCLES;
+
+  printf("scan 0x%02X-0x%02X: %.0f cycles probes, %.0f tasks, %.0f display - %.1f ms active\n",
+    TWI_ADDR_FIRST, TWI_ADDR_LAST, scan, busy - scan - DISPLAY_CYCLES, DISPLAY_CYCLES, busy / FCPU_MHZ / 1000);
+  printf("%9s %12s %12s %8s %8s\n", "period ms", "active cyc", "sleep cyc", "active", "mA");
+  for (i = 0; i < sizeof(PERIODS) / sizeof(PERIODS[0]); i++) {
+    // scan, then pause of period - core sleeps except tick and stats
+    total = busy + PERIODS[i] * 1000.0 * FCPU_MHZ;
+    share = busy + PERIODS[i] * TICK_CYCLES + (total / FCPU_MHZ / 1000 / STATS_MS) * STATS_CYCLES;
+    printf("%9u %12.0f %12.0f %7.2f%% %8.2f\n", PERIODS[i], share, total - share, 100 * share / total,
+      (share * active + (total - share) * idle) / total);
+  }
+  return 0;
+}
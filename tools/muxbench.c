@@ -0,0 +1,240 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Host check of switch traversal (lib/twimux.c)
+ * -------------------------------------------------------------+
+ *
+ * @file        muxbench.c
+ * @build       cc -O2 -Ilib -o muxbench tools/muxbench.c lib/twi.c
+ *                lib/twimux.c lib/hosttwi.c -lm
+ * @usage       muxbench [traversals]
+ *              two TCA9548A of host model (lib/hosttwi.c) with devices
+ *              on channels, plain device in switch range upstream
+ *              (checked first, gets the one write of detection);
+ *              detects switches and traverses them as scan task does,
+ *              prints devices per channel, probes against 8 full scans
+ *              per switch and bus time, then traversals with other
+ *              master at 30 % load; exit status 1 if detected
+ *              switches, devices of any channel, union of switch,
+ *              number of probes or channels off after traversal
+ *              differ from model
+ * -------------------------------------------------------------+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "twimux.h"
+
+// transaction of other master - address and 2 data bytes at ~100 kHz
+#define OTHER_US 300.0
+// load of other master in %
+#define OTHER_LOAD 30
+// work of scan task between steps - yield, other tasks
+#define GAP_US   100.0
+
+/** @array Upstream devices, 0x70 plain device in switch range */
+static const uint8_t DEVICES[] = { 0x20, 0x3C, 0x68, 0x70 };
+/** @array Switches, in order of detection */
+static const uint8_t SWITCHES[] = { 0x71, 0x74 };
+/** @array Devices behind switches - index of switch, channel, address */
+static const uint8_t BEHIND[][3] = {
+  { 0, 0, 0x48 },
+  { 0, 3, 0x48 },
+  { 0, 5, 0x50 },
+  { 0, 5, 0x51 },
+  { 1, 2, 0x29 },
+  { 1, 7, 0x40 }
+};
+
+/** @var Devices per channel - expected, reported */
+static uint8_t expect[MUX_MAX][MUX_CHANNELS][TWI_BITMAP_SIZE];
+static uint8_t report[MUX_MAX][MUX_CHANNELS][TWI_BITMAP_SIZE];
+
+/**
+ * @desc    Count of bits
+ *
+ * @param   const uint8_t * bitmap
+ * @return  unsigned
+ */
+static unsigned Count(const uint8_t *bitmap)
+{
+  unsigned address, count = 0;
+
+  for (address = 0; address < 128; address++) {
+    if (bitmap[address >> 3] & (1 << (address & 0x07))) {
+      count++;
+    }
+  }
+  return count;
+}
+
+/**
+ * @desc    Traverse as scan task does - step without progress
+ *          repeated after random backoff, skipped after
+ *          TWI_ARB_RETRIES, channel results taken before next step
+ *
+ * @param   TMuxMap *
+ * @param   const uint8_t * upstream
+ * @param   unsigned * retries
+ * @return  int 1 no step skipped
+ */
+static int Traverse(TMuxMap *map, const uint8_t *upstream, unsigned *retries)
+{
+  unsigned char attempt = 0;
+  uint8_t status;
+  int complete = 1;
+
+  memset(report, 0, sizeof(report));
+  MUX_Begin(map);
+  while ((status = MUX_Step(map, upstream, TWI_ADDR_FIRST, TWI_ADDR_LAST)) != MUX_DONE) {
+    if (status == MUX_RETRY) {
+      if (++attempt > TWI_ARB_RETRIES) {
+        MUX_Skip(map);
+        complete = 0;
+        attempt = 0;
+      } else {
+        (*retries)++;
+        // backoff in ms
+        HostTwiDelay(1000.0 * TWI_Backoff(attempt));
+        continue;
+      }
+    } else {
+      attempt = 0;
+      // channel result - sent out by scan task
+      if (status == MUX_CHANNEL) {
+        memcpy(report[map->index][map->channel.number], map->channel.devices, TWI_BITMAP_SIZE);
+      }
+    }
+    HostTwiDelay(GAP_US);
+  }
+  return complete;
+}
+
+/**
+ * @desc    Main
+ *
+ * @param   int argc
+ * @param   char ** argv
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+  uint8_t upstream[TWI_BITMAP_SIZE], expectUp[TWI_BITMAP_SIZE], devices[TWI_BITMAP_SIZE];
+  unsigned traversals = 200, i, m, c, a, complete = 0, wrong = 0, retries = 0;
+  unsigned probes, full;
+  unsigned char address;
+  unsigned char control;
+  TMuxMap map;
+  double start, time = 0;
+  int status = 0;
+
+  if ((argc > 1) && ((traversals = (unsigned) atoi(argv[1])) == 0)) {
+    fprintf(stderr, "usage: muxbench [traversals]\n");
+    return 2;
+  }
+  // model
+  memset(expectUp, 0, sizeof(expectUp));
+  for (i = 0; i < sizeof(DEVICES); i++) {
+    HostTwiDevice(DEVICES[i]);
+    expectUp[DEVICES[i] >> 3] |= (1 << (DEVICES[i] & 0x07));
+  }
+  for (i = 0; i < sizeof(SWITCHES); i++) {
+    HostTwiSwitch(SWITCHES[i]);
+    expectUp[SWITCHES[i] >> 3] |= (1 << (SWITCHES[i] & 0x07));
+  }
+  for (i = 0; i < sizeof(BEHIND) / sizeof(BEHIND[0]); i++) {
+    HostTwiBehind(SWITCHES[BEHIND[i][0]], BEHIND[i][1], BEHIND[i][2]);
+    m = BEHIND[i][0];
+    expect[m][BEHIND[i][1]][BEHIND[i][2] >> 3] |= (1 << (BEHIND[i][2] & 0x07));
+  }
+  TWI_Init();
+  TWI_TimerInit();
+
+  // upstream scan - channels off
+  memset(upstream, 0, sizeof(upstream));
+  for (address = TWI_ADDR_FIRST; address <= TWI_ADDR_LAST; address++) {
+    if (TWI_MT_Probe(address) == TWI_MT_SLAW_ACK) {
+      upstream[address >> 3] |= (1 << (address & 0x07));
+    }
+  }
+  if (memcmp(upstream, expectUp, TWI_BITMAP_SIZE)) {
+    printf("upstream scan differs from model\n");
+    status = 1;
+  }
+  // switches by control register
+  MUX_Detect(&map, upstream);
+  printf("switches %u:", map.count);
+  for (m = 0; m < map.count; m++) {
+    printf(" 0x%02x", map.mux[m].address);
+  }
+  printf(", bytes written to other devices %u\n", (unsigned) hostTwiWrites);
+  if ((map.count != sizeof(SWITCHES)) || (map.mux[0].address != SWITCHES[0]) ||
+      (map.mux[1].address != SWITCHES[1]) || (hostTwiWrites != 1)) {
+    printf("detected switches differ from model\n");
+    return 1;
+  }
+
+  // quiet bus - every channel exactly
+  start = hostTwiTime;
+  Traverse(&map, upstream, &retries);
+  time = hostTwiTime - start;
+  probes = 0;
+  full = 0;
+  for (m = 0; m < map.count; m++) {
+    memset(devices, 0, sizeof(devices));
+    for (c = 0; c < MUX_CHANNELS; c++) {
+      printf("0x%02x.%u:", map.mux[m].address, c);
+      for (a = 0; a < 128; a++) {
+        if (report[m][c][a >> 3] & (1 << (a & 0x07))) {
+          printf(" %02x", a);
+        }
+      }
+      printf("\n");
+      for (a = 0; a < TWI_BITMAP_SIZE; a++) {
+        devices[a] |= expect[m][c][a];
+      }
+    }
+    if (memcmp(report[m], expect[m], sizeof(expect[m])) || memcmp(map.mux[m].devices, devices, TWI_BITMAP_SIZE)) {
+      printf("devices of 0x%02x differ from model\n", map.mux[m].address);
+      status = 1;
+    }
+    // all channels at once, then union on every channel
+    probes += (TWI_ADDR_LAST - TWI_ADDR_FIRST + 1 - Count(upstream)) + MUX_CHANNELS * Count(devices);
+    full += MUX_CHANNELS * (TWI_ADDR_LAST - TWI_ADDR_FIRST + 1 - Count(upstream));
+  }
+  printf("probes %u (8 full scans per switch %u, %.1f %%), bus %.1f ms\n",
+    map.probes, full, 100.0 * map.probes / full, time / 1000);
+  if (map.probes != probes) {
+    printf("probes %u, expected %u\n", map.probes, probes);
+    status = 1;
+  }
+  // channels off after traversal
+  for (m = 0; m < map.count; m++) {
+    if ((TWI_MR_Read(map.mux[m].address, &control) != SUCCESS) || control) {
+      printf("channels of 0x%02x left on\n", map.mux[m].address);
+      status = 1;
+    }
+  }
+
+  // shared bus - steps repeated, complete traversals exact
+  HostTwiMaster(OTHER_LOAD * 10000.0 / OTHER_US, OTHER_US, 4321);
+  TWI_Seed(0xACE1);
+  retries = 0;
+  time = 0;
+  for (i = 0; i < traversals; i++) {
+    start = hostTwiTime;
+    if (Traverse(&map, upstream, &retries)) {
+      complete++;
+      time += hostTwiTime - start;
+      if (memcmp(report, expect, sizeof(report))) {
+        wrong++;
+      }
+    }
+  }
+  printf("load %u %%: complete %.1f %%, %.1f ms / traversal, %.2f retries, wrong %u\n", OTHER_LOAD,
+    100.0 * complete / traversals, complete ? time / complete / 1000 : 0, (double) retries / traversals, wrong);
+  if (wrong) {
+    status = 1;
+  }
+  return status;
+}
@@ -0,0 +1,269 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Host check of SSD1306 driver (lib/ssd1306.c)
+ * -------------------------------------------------------------+
+ *
+ * @file        oledbench.c
+ * @build       cc -O2 -Ilib -o oledbench tools/oledbench.c lib/ssd1306.c
+ *                lib/twi.c lib/hosttwi.c -lm
+ * @usage       oledbench
+ *              ssd1306.c draws over twi.c into display model on host
+ *              bus (lib/hosttwi.c) at 400 kHz - command and data
+ *              streams, column and page window, horizontal addressing;
+ *              scenes flushed one by one (aligned X1 characters, right
+ *              edge, unaligned and scaled characters, opaque text,
+ *              lines), last flush fails by NOT ACK and is repeated;
+ *              prints bytes and bus time per flush and of full frame;
+ *              exit status 1 if display differs from same scenes
+ *              redrawn after ClearScreen, failed flush reports success
+ *              or bytes differ from ones on bus
+ * -------------------------------------------------------------+
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ssd1306.h"
+#include "twi.h"
+
+// data byte of failing flush NOT acknowledged - inside page 3
+#define FAIL_BYTE (SSD1306_WIDTH + 3)
+
+/** @var Display RAM of model */
+static uint8_t ram[SSD1306_PAGES][SSD1306_WIDTH];
+/** @var Display RAM after scenes */
+static uint8_t shown[SSD1306_PAGES][SSD1306_WIDTH];
+/** @var Control byte of transfer */
+static uint8_t control;
+/** @var Command and its arguments */
+static uint8_t command[3];
+static uint8_t commandLength = 0;
+/** @var Window and pointer */
+static uint8_t colStart = 0, colEnd = SSD1306_WIDTH - 1, pageStart = 0, pageEnd = SSD1306_PAGES - 1;
+static uint8_t col = 0, page = 0;
+/** @var Bytes on bus - data bytes and SLA+W of transfers */
+static unsigned long busBytes = 0;
+/** @var Data bytes till NOT ACK, 0 never */
+static unsigned failAfter = 0;
+
+/**
+ * @desc    Number of arguments of command
+ *
+ * @param   uint8_t command
+ *
+ * @return  uint8_t
+ */
+static uint8_t Arguments(uint8_t code)
+{
+  switch (code) {
+    case SSD1306_COLUMN_ADDR:
+    case SSD1306_PAGE_ADDR:
+      return 2;
+    case SSD1306_MEMORY_MODE:
+    case SSD1306_CONTRAST:
+    case SSD1306_CHARGE_PUMP:
+    case SSD1306_MULTIPLEX:
+    case SSD1306_DISPLAY_OFFSET:
+    case SSD1306_CLOCK_DIV:
+    case SSD1306_PRECHARGE:
+    case SSD1306_COM_PINS:
+    case SSD1306_VCOM_DETECT:
+      return 1;
+  }
+  return 0;
+}
+
+/**
+ * @desc    Display model - control byte, then command or data stream
+ *
+ * @param   uint8_t byte
+ * @param   uint8_t first byte after SLA+W
+ *
+ * @return  uint8_t 0 NOT ACK
+ */
+static uint8_t Receive(uint8_t byte, uint8_t first)
+{
+  busBytes++;
+  // control byte - stream of transfer
+  if (first) {
+    busBytes++;
+    control = byte;
+    commandLength = 0;
+    return 1;
+  }
+  // data - window filled column by column, page by page
+  if (control & SSD1306_DATA) {
+    if (failAfter && (--failAfter == 0)) {
+      return 0;
+    }
+    ram[page][col] = byte;
+    if (col++ == colEnd) {
+      col = colStart;
+      page = (page == pageEnd) ? pageStart : page + 1;
+    }
+    return 1;
+  }
+  // command with arguments
+  command[commandLength++] = byte;
+  if (commandLength > Arguments(command[0])) {
+    if (command[0] == SSD1306_COLUMN_ADDR) {
+      colStart = col = command[1];
+      colEnd = command[2];
+    } else if (command[0] == SSD1306_PAGE_ADDR) {
+      pageStart = page = command[1];
+      pageEnd = command[2];
+    }
+    commandLength = 0;
+  }
+  return 1;
+}
+
+/**
+ * @desc    Scene - drawing between flushes
+ *
+ * @param   unsigned scene
+ *
+ * @return  void
+ */
+static void Scene(unsigned scene)
+{
+  switch (scene) {
+    // header - aligned X1 text, line
+    case 0:
+      SetPosition(2, 0);
+      DrawString("I2C SCANNER", WHITE, X1);
+      DrawLineHorizontal(0, SIZE_X, 10, WHITE);
+      break;
+    // list rows - aligned X1
+    case 1:
+      SetPosition(2, 16);
+      DrawString("0x3C 0x68", WHITE, X1);
+      SetPosition(2, 24);
+      DrawString("0x76", WHITE, X1);
+      break;
+    // right edge clipped, black character clears its bits
+    case 2:
+      SetPosition(124, 56);
+      DrawChar('Z', WHITE, X1);
+      SetPosition(2, 24);
+      DrawChar('0', BLACK, X1);
+      break;
+    // unaligned and scaled
+    case 3:
+      SetPosition(2, 35);
+      DrawString("ROW 35", WHITE, X1);
+      SetPosition(2, 44);
+      DrawString("X2", WHITE, X2);
+      SetPosition(60, 44);
+      DrawString("X3", WHITE, X3);
+      break;
+    // row rewritten with background
+    case 4:
+      SetPosition(2, 16);
+      DrawStringOpaque("0x20     ", WHITE, BLACK, X1);
+      break;
+    // lines, pixel, cleared rectangle
+    case 5:
+      DrawLine(0, SIZE_X, SIZE_Y, 0, WHITE);
+      DrawPixel(SIZE_X, SIZE_Y, WHITE);
+      DrawRectangle(100, 120, 50, 60, BLACK);
+      break;
+    // pages 0, 3 and last - flush fails in page 3
+    case 6:
+      DrawRectangle(0, SIZE_X, 0, 7, WHITE);
+      SetPosition(10, 24);
+      DrawString("RETRY", WHITE, X1);
+      DrawPixel(64, SIZE_Y, WHITE);
+      break;
+  }
+}
+
+/**
+ * @desc    Flush timed, bytes checked against bus
+ *
+ * @param   const char * label
+ * @param   int * status
+ *
+ * @return  uint8_t
+ */
+static uint8_t Flush(const char *label, int *status)
+{
+  double start = hostTwiTime;
+  uint8_t result;
+
+  busBytes = 0;
+  result = Ssd1306Flush();
+  printf("%-10s %5u bytes %7.2f ms%s\n", label, ssd1306Bytes, (hostTwiTime - start) / 1000,
+    (result == SSD1306_SUCCESS) ? "" : " - failed");
+  // bytes of successful flush as on bus
+  if ((result == SSD1306_SUCCESS) && (ssd1306Bytes != busBytes)) {
+    printf("%s: %u bytes counted, %lu on bus\n", label, ssd1306Bytes, busBytes);
+    *status = 1;
+  }
+  return result;
+}
+
+/**
+ * @desc    Main
+ *
+ * @param   void
+ *
+ * @return  int
+ */
+int main(void)
+{
+  char label[16];
+  unsigned scene, scenes = 7, p, c;
+  double start;
+  int status = 0;
+
+  HostTwiReceiver(SSD1306_ADDRESS, Receive);
+  TWI_Init();
+  TWI_SetSpeed(400);
+  if (Ssd1306Init() != SSD1306_SUCCESS) {
+    printf("init failed\n");
+    return 1;
+  }
+  Flush("init", &status);
+
+  // scenes flushed one by one, last flush fails and is repeated
+  for (scene = 0; scene < scenes; scene++) {
+    Scene(scene);
+    sprintf(label, "scene %u", scene);
+    if (scene == scenes - 1) {
+      failAfter = FAIL_BYTE;
+      if (Flush(label, &status) == SSD1306_SUCCESS) {
+        printf("flush with NOT ACK reports success\n");
+        status = 1;
+      }
+      failAfter = 0;
+      sprintf(label, "scene %u r", scene);
+    }
+    Flush(label, &status);
+  }
+  memcpy(shown, ram, sizeof(ram));
+
+  // same scenes on cleared screen - whole screen sent
+  ClearScreen(BLACK);
+  for (scene = 0; scene < scenes; scene++) {
+    Scene(scene);
+  }
+  Flush("redraw", &status);
+  if (memcmp(shown, ram, sizeof(ram))) {
+    for (p = 0; p < SSD1306_PAGES; p++) {
+      for (c = 0; c < SSD1306_WIDTH; c++) {
+        if (shown[p][c] != ram[p][c]) {
+          printf("page %u column %u: 0x%02x shown, 0x%02x drawn\n", p, c, shown[p][c], ram[p][c]);
+        }
+      }
+    }
+    status = 1;
+  }
+
+  // full frame
+  ClearScreen(WHITE);
+  start = hostTwiTime;
+  Flush("frame", &status);
+  printf("full frame %ux%u: %u bytes, %.1f ms at 400 kHz, %.1f fps\n", SSD1306_WIDTH, SSD1306_HEIGHT,
+    ssd1306Bytes, (hostTwiTime - start) / 1000, 1000000 / (hostTwiTime - start));
+  return status;
+}
@@ -0,0 +1,301 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Host decoder of profiler dump (lib/prof.h) - flat profile
+ * -------------------------------------------------------------+
+ *
+ * @file        profdec.c
+ * @build       cc -O2 -o profdec tools/profdec.c
+ * @usage       profdec [-b] symbols [dump ...]     (stdin without dump)
+ *                symbols  avr-nm -n -S --defined-only of same ELF
+ *                -b       samples of every bin with its symbols too
+ *              last complete dump (prof ... end) of input is used,
+ *              other serial output between lines is skipped; samples
+ *              of bin shared by several symbols split by bytes, such
+ *              symbols marked ~ - narrow window with prof on <start> <shift>
+ * -------------------------------------------------------------+
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+// max bins of dump
+#define BINS     256
+// max line
+#define LINE     512
+
+/** @struct Symbol of flash */
+typedef struct {
+  uint32_t start;
+  uint32_t end;
+  char *name;
+  double samples;
+  int shared;
+} TSymbol;
+
+/** @struct Dump */
+typedef struct {
+  uint32_t start;
+  unsigned shift;
+  unsigned count;
+  unsigned hz;
+  unsigned long samples;
+  unsigned long outside;
+  unsigned long bins[BINS];
+} TDump;
+
+/** @var Symbols by address */
+static TSymbol *symbols = NULL;
+static size_t symbolsCount = 0;
+
+/**
+ * @desc    Order by address, sized first at same address
+ *
+ * @param   const void *
+ * @param   const void *
+ * @return  int
+ */
+static int SymbolOrder(const void *a, const void *b)
+{
+  const TSymbol *x = a, *y = b;
+
+  if (x->start != y->start) {
+    return (x->start < y->start) ? -1 : 1;
+  }
+  return (x->end < y->end) - (x->end > y->end);
+}
+
+/**
+ * @desc    Order by samples, most first
+ *
+ * @param   const void *
+ * @param   const void *
+ * @return  int
+ */
+static int SamplesOrder(const void *a, const void *b)
+{
+  const TSymbol *x = a, *y = b;
+
+  return (x->samples < y->samples) - (x->samples > y->samples);
+}
+
+/**
+ * @desc    Read text symbols of avr-nm output, with or without -S
+ *
+ * @param   const char * file name
+ * @return  int 0 success
+ */
+static int SymbolsRead(const char *name)
+{
+  char line[LINE], *token[4];
+  TSymbol *symbol;
+  size_t i, j;
+  int n;
+  FILE *in;
+
+  if ((in = fopen(name, "r")) == NULL) {
+    perror(name);
+    return 1;
+  }
+  while (fgets(line, sizeof(line), in)) {
+    // addr [size] type name
+    for (n = 0; n < 4; n++) {
+      if ((token[n] = strtok(n ? NULL : line, " \t\r\n")) == NULL) {
+        break;
+      }
+    }
+    if ((n < 3) || (strlen(token[n - 2]) != 1)) {
+      continue;
+    }
+    // code only - data of AVR from 0x800000
+    if (!strchr("TtWw", token[n - 2][0]) || (strtoul(token[0], NULL, 16) >= 0x800000)) {
+      continue;
+    }
+    symbols = realloc(symbols, (symbolsCount + 1) * sizeof(TSymbol));
+    symbol = &symbols[symbolsCount++];
+    symbol->start = strtoul(token[0], NULL, 16);
+    symbol->end = symbol->start + ((n == 4) ? strtoul(token[1], NULL, 16) : 0);
+    symbol->name = strdup(token[n - 1]);
+    symbol->samples = 0;
+    symbol->shared = 0;
+  }
+  fclose(in);
+  // by address, aliases dropped
+  qsort(symbols, symbolsCount, sizeof(TSymbol), SymbolOrder);
+  for (i = j = 0; i < symbolsCount; i++) {
+    if (j && (symbols[j - 1].start == symbols[i].start)) {
+      free(symbols[i].name);
+      continue;
+    }
+    symbols[j++] = symbols[i];
+  }
+  symbolsCount = j;
+  // unknown size up to next symbol
+  for (i = 0; i < symbolsCount; i++) {
+    if (symbols[i].end == symbols[i].start) {
+      symbols[i].end = (i + 1 < symbolsCount) ? symbols[i + 1].start : symbols[i].start + 2;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @desc    Read dump lines, keep last complete dump
+ *
+ * @param   FILE *
+ * @param   TDump * last complete dump
+ * @return  int 1 complete dump found
+ */
+static int DumpRead(FILE *in, TDump *dump)
+{
+  static TDump current;
+  char line[LINE];
+  unsigned long address, count;
+  int open = 0, found = 0;
+
+  while (fgets(line, sizeof(line), in)) {
+    // header starts dump
+    if (sscanf(line, "prof %lx %u %u %u %lu %lu", &address, &current.shift, &current.count,
+          &current.hz, &current.samples, &current.outside) == 6) {
+      memset(current.bins, 0, sizeof(current.bins));
+      current.start = address;
+      open = (current.shift < 24) && (current.count <= BINS);
+    // end completes dump
+    } else if (open && !strncmp(line, "end", 3)) {
+      *dump = current;
+      open = 0;
+      found = 1;
+    // bin
+    } else if (open && (sscanf(line, "%lx %lu", &address, &count) == 2)) {
+      address = (address - current.start) >> current.shift;
+      if (address < BINS) {
+        current.bins[address] = count;
+      }
+    }
+  }
+  return found;
+}
+
+/**
+ * @desc    Split samples of bins over symbols
+ *
+ * @param   const TDump *
+ * @param   int bins - print every bin
+ * @return  double samples of no symbol
+ */
+static double Attribute(const TDump *dump, int bins)
+{
+  uint32_t start, end, from, to, width = 1UL << dump->shift;
+  double none = 0;
+  size_t i, first;
+  unsigned b;
+  int count;
+
+  for (b = 0; b < BINS; b++) {
+    if (!dump->bins[b]) {
+      continue;
+    }
+    start = dump->start + b * width;
+    end = start + width;
+    if (bins) {
+      printf("%05lx %8lu ", (unsigned long) start, dump->bins[b]);
+    }
+    // symbols in bin
+    for (first = 0; (first < symbolsCount) && (symbols[first].end <= start); first++);
+    count = 0;
+    for (i = first; (i < symbolsCount) && (symbols[i].start < end); i++) {
+      count++;
+    }
+    for (i = first; (i < symbolsCount) && (symbols[i].start < end); i++) {
+      from = (symbols[i].start > start) ? symbols[i].start : start;
+      to = (symbols[i].end < end) ? symbols[i].end : end;
+      symbols[i].samples += (double) dump->bins[b] * (to - from) / width;
+      symbols[i].shared |= (count > 1) || (to - from < width);
+      if (bins) {
+        printf(" %s", symbols[i].name);
+      }
+    }
+    if (bins) {
+      printf("\n");
+    }
+    // rest of bin without symbol
+    from = start;
+    for (i = first; (i < symbolsCount) && (symbols[i].start < end); i++) {
+      to = (symbols[i].start > from) ? symbols[i].start : from;
+      none += (double) dump->bins[b] * (to - from) / width;
+      from = (symbols[i].end > from) ? symbols[i].end : from;
+    }
+    none += (from < end) ? (double) dump->bins[b] * (end - from) / width : 0;
+  }
+  return none;
+}
+
+/**
+ * @desc    Main
+ *
+ * @param   int argc
+ * @param   char ** argv
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+  static TDump dump;
+  int bins = 0, found = 0, files = 0;
+  double none, total;
+  size_t i;
+  int arg;
+  FILE *in;
+
+  // options
+  for (arg = 1; (arg < argc) && (argv[arg][0] == '-'); arg++) {
+    if (strcmp(argv[arg], "-b") != 0) {
+      break;
+    }
+    bins = 1;
+  }
+  if ((arg >= argc) || (argv[arg][0] == '-')) {
+    fprintf(stderr, "usage: profdec [-b] symbols [dump ...]\n");
+    return 2;
+  }
+  if (SymbolsRead(argv[arg++])) {
+    return 1;
+  }
+  // dumps
+  for (; arg < argc; arg++) {
+    if ((in = fopen(argv[arg], "r")) == NULL) {
+      perror(argv[arg]);
+      return 1;
+    }
+    found |= DumpRead(in, &dump);
+    fclose(in);
+    files++;
+  }
+  if (!files) {
+    found = DumpRead(stdin, &dump);
+  }
+  if (!found || !dump.samples) {
+    fprintf(stderr, "no complete dump with samples\n");
+    return 1;
+  }
+
+  total = dump.samples;
+  printf("samples %lu at %u Hz (%.1f s), window %05lx-%05lx in bins of %lu bytes, outside %lu\n",
+    dump.samples, dump.hz, dump.hz ? total / dump.hz : 0.0, (unsigned long) dump.start,
+    (unsigned long) (dump.start + ((uint32_t) dump.count << dump.shift) - 1), 1UL << dump.shift, dump.outside);
+  none = Attribute(&dump, bins);
+  // flat profile
+  qsort(symbols, symbolsCount, sizeof(TSymbol), SamplesOrder);
+  printf("%7s %10s  %s\n", "%", "samples", "symbol");
+  for (i = 0; (i < symbolsCount) && (symbols[i].samples > 0); i++) {
+    printf("%7.2f %10.1f  %s%s\n", 100 * symbols[i].samples / total, symbols[i].samples,
+      symbols[i].name, symbols[i].shared ? " ~" : "");
+  }
+  if (none > 0) {
+    printf("%7.2f %10.1f  (no symbol)\n", 100 * none / total, none);
+  }
+  if (dump.outside) {
+    printf("%7.2f %10lu  (outside window)\n", 100.0 * dump.outside / total, dump.outside);
+  }
+  return 0;
+}
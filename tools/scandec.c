@@ -0,0 +1,290 @@
+/** 
+ * -------------------------------------------------------------+ 
+ * @desc        Host decoder of binary scan records (lib/scanlog.h)
+ * -------------------------------------------------------------+ 
+ *
+ * @file        scandec.c
+ * @build       cc -O2 -o scandec tools/scandec.c
+ * @usage       scandec [-c] [file ...]     (stdin without file)
+ *                -c  one CSV line per record: seq,time_ms,errors,addresses,
+ *                    channel frames as mux,switch,channel,addresses
+ *              without -c prints summary and presence count per address,
+ *              addresses behind switches as switch.channel:address
+ * -------------------------------------------------------------+ 
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+// frame layout - see lib/scanlog.h
+#define SYNC1    0xA5
+#define SYNC2    0x5A
+#define PAYLOAD  24
+#define FRAME    (3 + PAYLOAD + 2)
+// channel frame of switch
+#define CHANNEL  18
+// switches 0x70 - 0x77, channels
+#define SWITCHES 8
+#define CHANNELS 8
+// read chunk
+#define CHUNK    (1 << 20)
+
+/** @struct Decoder totals */
+typedef struct {
+  uint64_t records;
+  uint64_t crcErrors;
+  uint64_t skipped;
+  uint64_t seqGaps;
+  uint64_t present[128];
+  uint64_t channels;
+  uint64_t behind[SWITCHES][CHANNELS][128];
+  uint32_t lastSeq;
+  int haveSeq;
+} TTotals;
+
+/** @var CRC-16/CCITT table, reflected 0x8408 */
+static uint16_t crcTable[256];
+
+/**
+ * @desc    Build CRC table - same CRC as avr-libc _crc_ccitt_update
+ *
+ * @param   void
+ * @return  void
+ */
+static void CrcInit(void)
+{
+  unsigned i, j;
+  uint16_t crc;
+
+  for (i = 0; i < 256; i++) {
+    crc = i;
+    for (j = 0; j < 8; j++) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : (crc >> 1);
+    }
+    crcTable[i] = crc;
+  }
+}
+
+/**
+ * @desc    CRC of block
+ *
+ * @param   const uint8_t * data
+ * @param   size_t length
+ * @return  uint16_t
+ */
+static uint16_t Crc(const uint8_t *data, size_t length)
+{
+  uint16_t crc = 0xFFFF;
+
+  while (length--) {
+    crc = (crc >> 8) ^ crcTable[(crc ^ *data++) & 0xFF];
+  }
+  return crc;
+}
+
+/**
+ * @desc    Decode one valid frame
+ *
+ * @param   const uint8_t * frame
+ * @param   TTotals *
+ * @param   int csv
+ * @return  void
+ */
+static void Record(const uint8_t *f, TTotals *t, int csv)
+{
+  static const char hex[] = "0123456789abcdef";
+  uint32_t seq = f[3] | (f[4] << 8);
+  uint32_t time = f[5] | (f[6] << 8) | (f[7] << 16) | ((uint32_t) f[8] << 24);
+  uint32_t errors = f[25] | (f[26] << 8);
+  const uint8_t *bitmap = f + 9;
+  char line[64 + 128 * 3];
+  int n, a;
+
+  // sequence continuity, 16 bit wrap
+  if (t->haveSeq && (((t->lastSeq + 1) & 0xFFFF) != seq)) {
+    t->seqGaps++;
+  }
+  t->lastSeq = seq;
+  t->haveSeq = 1;
+  t->records++;
+
+  // presence counts
+  for (a = 0; a < 128; a++) {
+    if (bitmap[a >> 3] & (1 << (a & 7))) {
+      t->present[a]++;
+    }
+  }
+  // csv line
+  if (csv) {
+    n = sprintf(line, "%u,%u,%u,", (unsigned) seq, (unsigned) time, (unsigned) errors);
+    for (a = 0; a < 128; a++) {
+      if (bitmap[a >> 3] & (1 << (a & 7))) {
+        line[n++] = hex[a >> 4];
+        line[n++] = hex[a & 0x0F];
+        line[n++] = ' ';
+      }
+    }
+    line[n++] = '\n';
+    fwrite(line, 1, n, stdout);
+  }
+}
+
+/**
+ * @desc    Decode one valid channel frame
+ *
+ * @param   const uint8_t * frame
+ * @param   TTotals *
+ * @param   int csv
+ * @return  void
+ */
+static void Channel(const uint8_t *f, TTotals *t, int csv)
+{
+  static const char hex[] = "0123456789abcdef";
+  unsigned mux = f[3];
+  unsigned channel = f[4];
+  const uint8_t *bitmap = f + 5;
+  char line[64 + 128 * 3];
+  int n, a;
+
+  t->channels++;
+  // presence counts, switch range only
+  for (a = 0; a < 128; a++) {
+    if ((bitmap[a >> 3] & (1 << (a & 7))) && ((mux & ~7u) == 0x70) && (channel < CHANNELS)) {
+      t->behind[mux & 7][channel][a]++;
+    }
+  }
+  // csv line
+  if (csv) {
+    n = sprintf(line, "mux,%02x,%u,", mux, channel);
+    for (a = 0; a < 128; a++) {
+      if (bitmap[a >> 3] & (1 << (a & 7))) {
+        line[n++] = hex[a >> 4];
+        line[n++] = hex[a & 0x0F];
+        line[n++] = ' ';
+      }
+    }
+    line[n++] = '\n';
+    fwrite(line, 1, n, stdout);
+  }
+}
+
+/**
+ * @desc    Decode stream - frames may span chunks
+ *
+ * @param   FILE *
+ * @param   TTotals *
+ * @param   int csv
+ * @return  void
+ */
+static void Decode(FILE *in, TTotals *t, int csv)
+{
+  static uint8_t buffer[CHUNK + FRAME];
+  size_t length = 0;
+  size_t got;
+  size_t i;
+  size_t size;
+  const uint8_t *p;
+
+  while ((got = fread(buffer + length, 1, CHUNK, in)) > 0) {
+    length += got;
+    i = 0;
+    // whole frames in buffer
+    while (i + 3 <= length) {
+      // find sync - scan or channel frame
+      if ((buffer[i] != SYNC1) || (buffer[i + 1] != SYNC2) ||
+          ((buffer[i + 2] != PAYLOAD) && (buffer[i + 2] != CHANNEL))) {
+        p = memchr(buffer + i + 1, SYNC1, length - i - 1);
+        t->skipped += (p ? (size_t) (p - buffer) : length) - i;
+        i = p ? (size_t) (p - buffer) : length;
+        continue;
+      }
+      // frame not complete - next chunk
+      size = 3 + buffer[i + 2] + 2;
+      if (i + size > length) {
+        break;
+      }
+      // check crc from length byte
+      if (Crc(buffer + i + 2, 1 + buffer[i + 2]) != (buffer[i + size - 2] | (buffer[i + size - 1] << 8))) {
+        // resync after false sync
+        t->crcErrors++;
+        t->skipped++;
+        i++;
+        continue;
+      }
+      if (buffer[i + 2] == PAYLOAD) {
+        Record(buffer + i, t, csv);
+      } else {
+        Channel(buffer + i, t, csv);
+      }
+      i += size;
+    }
+    // keep partial frame
+    memmove(buffer, buffer + i, length - i);
+    length -= i;
+  }
+  t->skipped += length;
+}
+
+/**
+ * @desc    Main
+ *
+ * @param   int argc
+ * @param   char ** argv
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+  static TTotals totals;
+  static char out[1 << 16];
+  int csv = 0;
+  int files = 0;
+  int i, a, m, c;
+  FILE *in;
+
+  CrcInit();
+  setvbuf(stdout, out, _IOFBF, sizeof(out));
+
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-c") == 0) {
+      csv = 1;
+      continue;
+    }
+    if ((in = fopen(argv[i], "rb")) == NULL) {
+      perror(argv[i]);
+      return 1;
+    }
+    Decode(in, &totals, csv);
+    fclose(in);
+    files++;
+  }
+  if (!files) {
+    Decode(stdin, &totals, csv);
+  }
+
+  // summary to stderr in csv mode
+  fflush(stdout);
+  in = csv ? stderr : stdout;
+  fprintf(in, "records %llu, channels %llu, crc errors %llu, skipped bytes %llu, sequence gaps %llu\n",
+    (unsigned long long) totals.records, (unsigned long long) totals.channels,
+    (unsigned long long) totals.crcErrors, (unsigned long long) totals.skipped,
+    (unsigned long long) totals.seqGaps);
+  if (!csv) {
+    for (a = 0; a < 128; a++) {
+      if (totals.present[a]) {
+        fprintf(in, "0x%02x %llu\n", a, (unsigned long long) totals.present[a]);
+      }
+    }
+    for (m = 0; m < SWITCHES; m++) {
+      for (c = 0; c < CHANNELS; c++) {
+        for (a = 0; a < 128; a++) {
+          if (totals.behind[m][c][a]) {
+            fprintf(in, "0x%02x.%d:0x%02x %llu\n", 0x70 + m, c, a, (unsigned long long) totals.behind[m][c][a]);
+          }
+        }
+      }
+    }
+  }
+  return 0;
+}
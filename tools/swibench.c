@@ -0,0 +1,98 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Host benchmark of software I2C buses (lib/swi.c)
+ * -------------------------------------------------------------+
+ *
+ * @file        swibench.c
+ * @build       cc -O2 -Ilib -DSWI_BUSES=4 -o swibench tools/swibench.c
+ *                lib/swi.c lib/hostswi.c
+ * @usage       swibench [-s bus]
+ *                -s  SCL of bus held low by slave
+ *              scans 0x08 - 0x77 on SWI_BUSES buses of host model
+ *              with fixed devices, prints bus time of scan from delays
+ *              of swi.c and port writes, exit status 1 if bitmap of
+ *              any bus differs from devices of model; build with
+ *              SWI_BUSES=1 scans one bus - N sequential scans take
+ *              N times its time
+ * -------------------------------------------------------------+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "swi.h"
+
+// scanned addresses
+#define FIRST 0x08
+#define LAST  0x77
+
+/** @array Devices of model - bus, address */
+static const uint8_t DEVICES[][2] = {
+  { 0, 0x3C }, { 0, 0x68 },
+  { 1, 0x50 }, { 1, 0x51 }, { 1, 0x52 }, { 1, 0x53 },
+  { 2, 0x20 }, { 2, 0x76 },
+  { 3, 0x48 }
+};
+
+/**
+ * @desc    Main
+ *
+ * @param   int argc
+ * @param   char ** argv
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+  static SWI_ScanState scan;
+  uint8_t expect[SWI_BUSES][16];
+  uint8_t stuck = 0xFF;
+  unsigned i, bus, found;
+  double time;
+  int status = 0;
+
+  // arguments
+  for (i = 1; i < (unsigned) argc; i++) {
+    if (!strcmp(argv[i], "-s") && (i + 1 < (unsigned) argc) && ((unsigned) atoi(argv[i + 1]) < SWI_BUSES)) {
+      stuck = (uint8_t) atoi(argv[++i]);
+    } else {
+      fprintf(stderr, "usage: swibench [-s bus]\n");
+      return 2;
+    }
+  }
+  // devices of buses present in build
+  memset(expect, 0, sizeof(expect));
+  for (i = 0; i < sizeof(DEVICES) / sizeof(DEVICES[0]); i++) {
+    if (DEVICES[i][0] < SWI_BUSES) {
+      HostSwiDevice(DEVICES[i][0], DEVICES[i][1]);
+      expect[DEVICES[i][0]][DEVICES[i][1] >> 3] |= (1 << (DEVICES[i][1] & 0x07));
+    }
+  }
+  // stuck bus finds nothing
+  if (stuck != 0xFF) {
+    HostSwiStuck(stuck, 1);
+    memset(expect[stuck], 0, sizeof(expect[stuck]));
+  }
+
+  SWI_Init();
+  time = hostSwiTime;
+  // one step per address as command task does
+  SWI_ScanBegin(&scan, FIRST, LAST);
+  while (SWI_ScanStep(&scan));
+  time = hostSwiTime - time;
+
+  printf("buses %d: scan 0x%02X-0x%02X %.0f us, %.0f us per bus, %lu port writes\n", SWI_BUSES, FIRST, LAST,
+    time, time / SWI_BUSES, (unsigned long) hostSwiWrites);
+  // merged bitmaps against model
+  for (bus = 0; bus < SWI_BUSES; bus++) {
+    found = 0;
+    for (i = 0; i < 128; i++) {
+      found += (scan.bitmaps[bus][i >> 3] >> (i & 0x07)) & 1;
+    }
+    if (memcmp(scan.bitmaps[bus], expect[bus], 16)) {
+      status = 1;
+    }
+    printf("  bus %u: %u devices%s%s\n", bus, found, (bus == stuck) ? ", SCL held low" : "",
+      memcmp(scan.bitmaps[bus], expect[bus], 16) ? ", differs from model" : "");
+  }
+  return status;
+}
@@ -0,0 +1,203 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Host benchmark of scan on bus shared with other master
+ * -------------------------------------------------------------+
+ *
+ * @file        twibench.c
+ * @build       cc -O2 -Ilib -o twibench tools/twibench.c lib/twi.c
+ *                lib/hosttwi.c -lm
+ * @usage       twibench [scans]
+ *              probes of twi.c on host model of bus (lib/hosttwi.c),
+ *              first full scan and verify of cached devices at power
+ *              on on quiet bus, then
+ *              other master holds bus for 300 us transactions at
+ *              random times, 10 % of them address scanner slave
+ *              (0x5A) and are served by ISR of twi.c; for every load
+ *              prints share of complete scans and scan time with retry
+ *              and backoff of scan task against scan aborted by first
+ *              lost arbitration, and transfers served as slave; exit
+ *              status 1 if scan with retries reports wrong device or
+ *              probe ends with other status than ACK, NACK, lost
+ *              arbitration or busy bus
+ * -------------------------------------------------------------+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "twi.h"
+
+// transaction of other master - address and 2 data bytes at ~100 kHz
+#define OTHER_US 300.0
+// work of scan task between probes - yield, other tasks
+#define GAP_US   100.0
+// own slave address, share of other master transactions to it
+#define SLAVE    0x5A
+#define SLAVE_SHARE 0.1
+
+/** @array Devices of model */
+static const uint8_t DEVICES[] = { 0x20, 0x3C, 0x50, 0x68, 0x76 };
+
+/** @struct Results of scans at one load */
+typedef struct {
+  unsigned complete;
+  unsigned wrong;
+  unsigned errors;
+  unsigned long served;
+  double time;
+  unsigned long arbLost;
+  unsigned long giveUps;
+} TResult;
+
+/**
+ * @desc    Scan 0x08 - 0x77 as scan task does - lost arbitration or
+ *          busy bus retried TWI_ARB_RETRIES times after random backoff,
+ *          or whole scan aborted at first loss
+ *
+ * @param   uint8_t * bitmap
+ * @param   int retry
+ * @param   TResult *
+ * @return  int 1 complete
+ */
+static int Scan(uint8_t *bitmap, int retry, TResult *result)
+{
+  unsigned char address, attempt, status;
+
+  memset(bitmap, 0, TWI_BITMAP_SIZE);
+  for (address = TWI_ADDR_FIRST; address <= TWI_ADDR_LAST; address++) {
+    // own slave address is not probed
+    if (address == SLAVE) {
+      continue;
+    }
+    attempt = 0;
+    while (1) {
+      status = TWI_MT_Probe(address);
+      if ((status != TWI_FLAG_ARB_LOST) && (status != TWI_BUS_BUSY)) {
+        break;
+      }
+      result->arbLost++;
+      // scan without retries ends
+      if (!retry) {
+        return 0;
+      }
+      if (++attempt > TWI_ARB_RETRIES) {
+        result->giveUps++;
+        break;
+      }
+      // backoff in ms
+      HostTwiDelay(1000.0 * TWI_Backoff(attempt));
+    }
+    if (status == TWI_MT_SLAW_ACK) {
+      bitmap[address >> 3] |= (1 << (address & 0x07));
+    } else if (status != TWI_MT_SLAW_NACK) {
+      // slave addressed by winner must come as lost arbitration
+      if ((status != TWI_FLAG_ARB_LOST) && (status != TWI_BUS_BUSY)) {
+        result->errors++;
+      }
+      return 0;
+    }
+    HostTwiDelay(GAP_US);
+  }
+  return 1;
+}
+
+/**
+ * @desc    Verify of cached topology as first scan after power on
+ *          does - cached addresses only, quiet bus
+ *
+ * @param   const uint8_t * cached bitmap
+ * @return  int 1 every cached device acknowledged
+ */
+static int Verify(const uint8_t *cached)
+{
+  unsigned char address;
+
+  for (address = TWI_ADDR_FIRST; address <= TWI_ADDR_LAST; address++) {
+    if (cached[address >> 3] & (1 << (address & 0x07))) {
+      if (TWI_MT_Probe(address) != TWI_MT_SLAW_ACK) {
+        return 0;
+      }
+      HostTwiDelay(GAP_US);
+    }
+  }
+  return 1;
+}
+
+/**
+ * @desc    Main
+ *
+ * @param   int argc
+ * @param   char ** argv
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+  static const unsigned LOADS[] = { 0, 10, 30, 50, 70 };
+  uint8_t expect[TWI_BITMAP_SIZE], bitmap[TWI_BITMAP_SIZE];
+  unsigned scans = 200, load, scan, i;
+  TResult result[2];
+  double start;
+  int retry, status = 0;
+
+  if ((argc > 1) && ((scans = (unsigned) atoi(argv[1])) == 0)) {
+    fprintf(stderr, "usage: twibench [scans]\n");
+    return 2;
+  }
+  memset(expect, 0, sizeof(expect));
+  for (i = 0; i < sizeof(DEVICES); i++) {
+    HostTwiDevice(DEVICES[i]);
+    expect[DEVICES[i] >> 3] |= (1 << (DEVICES[i] & 0x07));
+  }
+  TWI_Init();
+  TWI_TimerInit();
+  // other master reads and writes scanner slave
+  TWI_SL_Init(SLAVE);
+  HostTwiSlave(SLAVE_SHARE);
+
+  // power on, quiet bus - full scan without cache, verify of cache
+  memset(result, 0, sizeof(result));
+  start = hostTwiTime;
+  if (!Scan(bitmap, 1, &result[1]) || memcmp(bitmap, expect, TWI_BITMAP_SIZE)) {
+    status = 1;
+  }
+  printf("power on: full scan %.1f ms, ", (hostTwiTime - start) / 1000);
+  start = hostTwiTime;
+  if (!Verify(expect)) {
+    status = 1;
+  }
+  printf("verify of %u cached %.2f ms\n", (unsigned) sizeof(DEVICES), (hostTwiTime - start) / 1000);
+
+  printf("load  %-37s  %-30s\n", "retry and backoff", "abort at first loss");
+  printf("%4s  %8s %8s %6s %5s %6s  %8s %8s %6s\n", "%", "complete", "ms/scan", "arb", "given", "slave",
+    "complete", "ms/scan", "arb");
+  for (load = 0; load < sizeof(LOADS) / sizeof(LOADS[0]); load++) {
+    memset(result, 0, sizeof(result));
+    for (retry = 1; retry >= 0; retry--) {
+      // same traffic for both
+      HostTwiMaster(LOADS[load] * 10000.0 / OTHER_US, OTHER_US, 12345 + load);
+      TWI_Seed(0xACE1);
+      hostTwiServed = 0;
+      for (scan = 0; scan < scans; scan++) {
+        start = hostTwiTime;
+        if (Scan(bitmap, retry, &result[retry])) {
+          result[retry].complete++;
+          result[retry].time += hostTwiTime - start;
+          if (memcmp(bitmap, expect, TWI_BITMAP_SIZE)) {
+            result[retry].wrong++;
+          }
+        }
+      }
+      result[retry].served = hostTwiServed;
+    }
+    printf("%4u  %7.1f%% %8.1f %6.2f %5.2f %6.2f  %7.1f%% %8.1f %6.2f\n", LOADS[load],
+      100.0 * result[1].complete / scans, result[1].complete ? result[1].time / result[1].complete / 1000 : 0,
+      (double) result[1].arbLost / scans, (double) result[1].giveUps / scans, (double) result[1].served / scans,
+      100.0 * result[0].complete / scans, result[0].complete ? result[0].time / result[0].complete / 1000 : 0,
+      (double) result[0].arbLost / scans);
+    // complete scan with retries - devices of model exactly
+    if (result[1].wrong || result[1].errors || result[0].errors) {
+      status = 1;
+    }
+  }
+  return status;
+}
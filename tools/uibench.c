@@ -0,0 +1,622 @@
+/**
+ * -------------------------------------------------------------+
+ * @desc        Host benchmark of display drawing (DISPLAY_HOST)
+ * -------------------------------------------------------------+
+ *
+ * @file        uibench.c
+ * @build       cc -O2 -DDISPLAY_BACKEND=DISPLAY_HOST -Ilib -o uibench tools/uibench.c
+ *                lib/st7735.c lib/hostlcd.c lib/number.c lib/sched.c lib/perf.c
+ * @usage       uibench [-w dir | -c dir] [frames]
+ *                -w  write display memory after every scene to dir/<scene>.ppm
+ *                -c  compare display memory after every scene with dir/<scene>.ppm,
+ *                    exit status 1 if any pixel differs
+ *              every scene drawn frames times (default 100) through
+ *              st7735.c, prints controller bytes per frame and drawn
+ *              pixels per second of host time; runs under perf / gprof,
+ *              with -DPERF_COUNTERS driver counters per frame follow
+ * -------------------------------------------------------------+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "display.h"
+#include "number.h"
+#include "perf.h"
+
+// layout of scanner screen - see main.c
+#define LIST_COLS     8
+#define LIST_Y        35
+#define STATS_Y       118
+#define STATS_NUMBERS 4
+// list redrawn every n-th frame, like scan results
+#define LIST_EVERY    10
+
+// console lines - whole memory height
+#define CONSOLE_LINES (SCROLL_LINES / CONSOLE_LINE_HEIGHT)
+
+/** @struct Scene - name, setup not measured, drawing of one frame, golden screen */
+typedef struct {
+  const char *name;
+  void (*prepare)(void);
+  void (*draw)(unsigned);
+  const char *golden;
+} TScene;
+
+/**
+ * @desc    Scanner screen - title, device list, stats numbers
+ *
+ * @param   unsigned frame
+ * @return  void
+ */
+static void SceneScreen(unsigned frame)
+{
+  static TNumber numbers[STATS_NUMBERS];
+  char msg[20];
+  unsigned address, count = 0, i;
+
+  // static part
+  if (frame == 0) {
+    SetPosition(25, 5);
+    DrawString("TWI / I2C SCANNER", WHITE, X1);
+    SetPosition(2, STATS_Y);
+    DrawStringOpaque("S:  % D:  % Z:  % #", WHITE, BLACK, X1);
+    for (i = 0; i < STATS_NUMBERS - 1; i++) {
+      NumberInit(&numbers[i], 2 + (2 + i * 6) * (CHARS_COLS_LEN + 1), STATS_Y, 2, 10, WHITE, BLACK);
+    }
+    NumberInit(&numbers[i], 2 + 19 * (CHARS_COLS_LEN + 1), STATS_Y, 5, 10, WHITE, BLACK);
+  }
+  // scan result - about every fourth address present
+  if ((frame % LIST_EVERY) == 0) {
+    DrawRectangle(0, SIZE_X, LIST_Y - 15, STATS_Y - 2, BLACK);
+    srand(frame / LIST_EVERY);
+    for (address = 0x08; address <= 0x77; address++) {
+      if (((rand() & 3) == 0) && (count < 6 * LIST_COLS)) {
+        SetPosition(2 + (count % LIST_COLS) * 20, LIST_Y + (count / LIST_COLS) * 10);
+        NumberFormat(msg, address, 16, 2, '0');
+        DrawString(msg, WHITE, X1);
+        count++;
+      }
+    }
+    SetPosition(18, 20);
+    strcpy(msg, "Devices found: ");
+    NumberFormat(msg + strlen(msg), count, 10, 0, ' ');
+    DrawString(msg, WHITE, X1);
+  }
+  // stats
+  for (i = 0; i < STATS_NUMBERS - 1; i++) {
+    NumberDraw(&numbers[i], (frame * (i + 3)) % 100);
+  }
+  NumberDraw(&numbers[i], frame);
+  UpdateScreen();
+}
+
+/**
+ * @desc    Text - all sizes, transparent and opaque
+ *
+ * @param   unsigned frame
+ * @return  void
+ */
+static void SceneText(unsigned frame)
+{
+  // same every frame
+  (void) frame;
+  // transparent
+  SetPosition(2, 2);
+  DrawString("!\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ", WHITE, X1);
+  SetPosition(2, 40);
+  DrawString("[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~", ST7735_RGB(0, 255, 0), X2);
+  SetPosition(2, 84);
+  DrawString("X3 text", ST7735_RGB(255, 255, 0), X3);
+  // opaque
+  SetPosition(2, 106);
+  DrawStringOpaque("Opaque 0123", WHITE, ST7735_RGB(0, 0, 255), X1);
+  SetPosition(80, 106);
+  DrawStringOpaque("X2", BLACK, WHITE, X2);
+}
+
+/**
+ * @desc    Lines - fan from center, horizontal and vertical
+ *
+ * @param   unsigned frame
+ * @return  void
+ */
+static void SceneLines(unsigned frame)
+{
+  uint8_t i;
+
+  // same every frame
+  (void) frame;
+  // fan to border
+  for (i = 0; i < MAX_X; i += 8) {
+    DrawLine(MAX_X / 2, i, MAX_Y / 2, 0, WHITE);
+    DrawLine(MAX_X / 2, i, MAX_Y / 2, SIZE_Y, RED);
+  }
+  for (i = 0; i < MAX_Y; i += 8) {
+    DrawLine(MAX_X / 2, 0, MAX_Y / 2, i, ST7735_RGB(0, 255, 255));
+    DrawLine(MAX_X / 2, SIZE_X, MAX_Y / 2, i, ST7735_RGB(255, 0, 255));
+  }
+  // frame
+  DrawLineHorizontal(0, SIZE_X, 0, WHITE);
+  DrawLineHorizontal(0, SIZE_X, SIZE_Y, WHITE);
+  DrawLineVertical(0, 0, SIZE_Y, WHITE);
+  DrawLineVertical(SIZE_X, 0, SIZE_Y, WHITE);
+}
+
+/**
+ * @desc    Fills and outlines - rectangles, circles, triangles
+ *
+ * @param   unsigned frame
+ * @return  void
+ */
+static void SceneFills(unsigned frame)
+{
+  // same every frame
+  (void) frame;
+  // rectangles
+  DrawRectangle(4, 40, 4, 30, RED);
+  FillRoundRectangle(48, 90, 4, 30, 8, ST7735_RGB(0, 255, 0));
+  DrawRoundRectangle(98, 150, 4, 30, 6, WHITE);
+  // circles, partly off screen
+  FillCircle(30, 70, 20, ST7735_RGB(0, 0, 255));
+  DrawCircle(80, 70, 24, WHITE);
+  FillCircle(150, 70, 20, ST7735_RGB(255, 255, 0));
+  // triangles
+  FillTriangle(10, 125, 40, 95, 70, 125, ST7735_RGB(255, 0, 255));
+  DrawTriangle(80, 125, 110, 95, 140, 120, WHITE);
+}
+
+/** @var Pixels of reference drawn in frame - every pixel sent once */
+static uint8_t refDrawn[ST7735_ROWS][ST7735_ROWS];
+
+/**
+ * @desc    Pixel of reference, clipped to screen, once per frame
+ *
+ * @param   int x
+ * @param   int y
+ * @param   uint16_t color
+ * @return  void
+ */
+static void RefPixel(int x, int y, uint16_t color)
+{
+  if ((x >= 0) && (y >= 0) && (x <= SIZE_X) && (y <= SIZE_Y) && !refDrawn[y][x]) {
+    refDrawn[y][x] = 1;
+    DrawPixel(x, y, color);
+  }
+}
+
+/**
+ * @desc    Row of reference pixels
+ *
+ * @param   int x start
+ * @param   int x end
+ * @param   int y
+ * @param   uint16_t color
+ * @return  void
+ */
+static void RefRow(int xs, int xe, int y, uint16_t color)
+{
+  int x;
+
+  for (x = (xs < xe) ? xs : xe; x <= ((xs < xe) ? xe : xs); x++) {
+    RefPixel(x, y, color);
+  }
+}
+
+/**
+ * @desc    Midpoint circle pixel by pixel - corners at x0 / x1, y0 / y1
+ *
+ * @param   int x left corner
+ * @param   int x right corner
+ * @param   int y top corner
+ * @param   int y bottom corner
+ * @param   int radius
+ * @param   int fill
+ * @param   uint16_t color
+ * @return  void
+ */
+static void RefCorners(int x0, int x1, int y0, int y1, int r, int fill, uint16_t color)
+{
+  int x = 0, y = r, d = 1 - r, row;
+
+  // center rows
+  for (row = y0; fill && (row <= y1); row++) {
+    RefRow(x0 - r, x1 + r, row, color);
+  }
+  while (x <= y) {
+    // all octants
+    if (fill) {
+      RefRow(x0 - x, x1 + x, y0 - y, color);
+      RefRow(x0 - x, x1 + x, y1 + y, color);
+      RefRow(x0 - y, x1 + y, y0 - x, color);
+      RefRow(x0 - y, x1 + y, y1 + x, color);
+    } else {
+      RefPixel(x0 - x, y0 - y, color);
+      RefPixel(x1 + x, y0 - y, color);
+      RefPixel(x0 - x, y1 + y, color);
+      RefPixel(x1 + x, y1 + y, color);
+      RefPixel(x0 - y, y0 - x, color);
+      RefPixel(x1 + y, y0 - x, color);
+      RefPixel(x0 - y, y1 + x, color);
+      RefPixel(x1 + y, y1 + x, color);
+    }
+    if (d < 0) {
+      d += 2 * x + 3;
+    } else {
+      d += 2 * (x - y) + 5;
+      y--;
+    }
+    x++;
+  }
+}
+
+/**
+ * @desc    Bresenham segment pixel by pixel
+ *
+ * @param   int x start
+ * @param   int y start
+ * @param   int x end
+ * @param   int y end
+ * @param   uint16_t color
+ * @return  void
+ */
+static void RefSegment(int x0, int y0, int x1, int y1, uint16_t color)
+{
+  int dx = abs(x1 - x0), dy = abs(y1 - y0);
+  int tx = (x1 < x0) ? -1 : 1, ty = (y1 < y0) ? -1 : 1;
+  int error;
+
+  if (dy <= dx) {
+    for (error = dx >> 1; x0 != x1; x0 += tx) {
+      RefPixel(x0, y0, color);
+      if ((error -= dy) < 0) {
+        y0 += ty;
+        error += dx;
+      }
+    }
+  } else {
+    for (error = dy >> 1; y0 != y1; y0 += ty) {
+      RefPixel(x0, y0, color);
+      if ((error -= dx) < 0) {
+        x0 += tx;
+        error += dy;
+      }
+    }
+  }
+  RefPixel(x0, y0, color);
+}
+
+/**
+ * @desc    Scanline triangle pixel by pixel, vertices sorted by y
+ *
+ * @param   int x top, y top, x middle, y middle, x bottom, y bottom
+ * @param   uint16_t color
+ * @return  void
+ */
+static void RefTriangle(int x0, int y0, int xm, int ym, int xl, int yl, uint16_t color)
+{
+  int y;
+
+  for (y = y0; y <= yl; y++) {
+    if ((y < ym) || ((y == ym) && (ym == yl))) {
+      RefRow(x0 + (xm - x0) * (y - y0) / (ym - y0), x0 + (xl - x0) * (y - y0) / (yl - y0), y, color);
+    } else {
+      RefRow(xm + (xl - xm) * (y - ym) / (yl - ym), x0 + (xl - x0) * (y - y0) / (yl - y0), y, color);
+    }
+  }
+}
+
+/**
+ * @desc    Fills scene pixel by pixel - reference of span rasterizers,
+ *          compared with golden screen of fills
+ *
+ * @param   unsigned frame
+ * @return  void
+ */
+static void SceneFillsPixels(unsigned frame)
+{
+  int y;
+
+  // same every frame
+  (void) frame;
+  memset(refDrawn, 0, sizeof(refDrawn));
+  // rectangles, radius within half of shorter side
+  for (y = 4; y <= 30; y++) {
+    RefRow(4, 40, y, RED);
+  }
+  RefCorners(48 + 8, 90 - 8, 4 + 8, 30 - 8, 8, 1, ST7735_RGB(0, 255, 0));
+  RefRow(98 + 6, 150 - 6, 4, WHITE);
+  RefRow(98 + 6, 150 - 6, 30, WHITE);
+  for (y = 4 + 6; y <= 30 - 6; y++) {
+    RefPixel(98, y, WHITE);
+    RefPixel(150, y, WHITE);
+  }
+  RefCorners(98 + 6, 150 - 6, 4 + 6, 30 - 6, 6, 0, WHITE);
+  // circles
+  RefCorners(30, 30, 70, 70, 20, 1, ST7735_RGB(0, 0, 255));
+  RefCorners(80, 80, 70, 70, 24, 0, WHITE);
+  RefCorners(150, 150, 70, 70, 20, 1, ST7735_RGB(255, 255, 0));
+  // triangles
+  RefTriangle(40, 95, 10, 125, 70, 125, ST7735_RGB(255, 0, 255));
+  RefSegment(80, 125, 110, 95, WHITE);
+  RefSegment(110, 95, 140, 120, WHITE);
+  RefSegment(140, 120, 80, 125, WHITE);
+}
+
+/**
+ * @desc    Log line of frame
+ *
+ * @param   char * line CONSOLE_LINE_CHARS + 1
+ * @param   unsigned frame
+ * @return  void
+ */
+static void ConsoleLine(char *line, unsigned frame)
+{
+  uint8_t i;
+
+  // scan number and some addresses, rest blank
+  memset(line, ' ', CONSOLE_LINE_CHARS);
+  line[CONSOLE_LINE_CHARS] = '\0';
+  memcpy(line, "scan", 4);
+  NumberFormat(line + 5, frame, 10, 5, '0');
+  line[10] = ' ';
+  for (i = 0; i < 3; i++) {
+    NumberFormat(line + 11 + i * 3, (frame * (i + 5)) & 0x7F, 16, 2, '0');
+    line[13 + i * 3] = ' ';
+  }
+}
+
+/**
+ * @desc    Console setup - scroll area of whole memory
+ *
+ * @param   void
+ * @return  void
+ */
+static void PrepareConsole(void)
+{
+  ConsoleInit(0, CONSOLE_LINES, WHITE, BLACK);
+}
+
+/**
+ * @desc    Console - one line appended by hardware scroll
+ *
+ * @param   unsigned frame
+ * @return  void
+ */
+static void SceneConsole(unsigned frame)
+{
+  char line[CONSOLE_LINE_CHARS + 1];
+
+  ConsoleLine(line, frame);
+  ConsolePrint(line);
+}
+
+/**
+ * @desc    Repaint setup - console orientation
+ *
+ * @param   void
+ * @return  void
+ */
+static void PrepareRepaint(void)
+{
+  SetRotation(CONSOLE_ROTATION);
+}
+
+/**
+ * @desc    Log without scroll - every line repainted one up, new at bottom
+ *
+ * @param   unsigned frame
+ * @return  void
+ */
+static void SceneRepaint(unsigned frame)
+{
+  char line[CONSOLE_LINE_CHARS + 1];
+  uint8_t i;
+
+  for (i = 0; i < CONSOLE_LINES; i++) {
+    // line of row, none before first frame
+    ConsoleLine(line, frame + i + 1 - CONSOLE_LINES);
+    if (frame + i + 1 < CONSOLE_LINES) {
+      memset(line, ' ', CONSOLE_LINE_CHARS);
+    }
+    // text and gap rows below it
+    SetPosition(0, i * CONSOLE_LINE_HEIGHT);
+    DrawStringOpaque(line, WHITE, BLACK, X1);
+    DrawRectangle(0, SIZE_X, i * CONSOLE_LINE_HEIGHT + CHARS_ROWS_LEN, (i + 1) * CONSOLE_LINE_HEIGHT - 1, BLACK);
+  }
+}
+
+/**
+ * @desc    Rotations - marked corners in every rotation, last 90 degrees
+ *
+ * @param   unsigned frame
+ * @return  void
+ */
+static void SceneRotate(unsigned frame)
+{
+  uint8_t rotation;
+
+  // same every frame
+  (void) frame;
+  for (rotation = ROTATE_0; rotation <= ROTATE_270; rotation++) {
+    SetRotation(rotation);
+    SetPosition(2 + rotation * 8, 2);
+    DrawString("R", WHITE, X1);
+    DrawRectangle(SIZE_X - 10, SIZE_X - 2, 2 + rotation * 12, 10 + rotation * 12, RED);
+  }
+  SetRotation(ROTATE_90);
+}
+
+/** @array Scenes */
+static const TScene SCENES[] = {
+  { "screen",  NULL,           SceneScreen,      "screen" },
+  { "text",    NULL,           SceneText,        "text" },
+  { "lines",   NULL,           SceneLines,       "lines" },
+  { "fills",   NULL,           SceneFills,       "fills" },
+  { "fillpx",  NULL,           SceneFillsPixels, "fills" },
+  { "rotate",  NULL,           SceneRotate,      "rotate" },
+  { "console", PrepareConsole, SceneConsole,     "console" },
+  { "repaint", PrepareRepaint, SceneRepaint,     "repaint" }
+};
+
+#ifdef ST7735_ASYNC
+/**
+ * @desc    Queued output - CPU left to main program while clear
+ *          screen is sent, cycles of model at ST7735_SPI_DIV
+ *
+ * @param   void
+ * @return  void
+ */
+static void AsyncReport(void)
+{
+  uint32_t cycles, isr, bytes, work = 0;
+
+  // nothing in transfer
+  St7735Flush();
+  cycles = hostCycles;
+  isr = hostIsrCycles;
+  bytes = hostLcdBytes;
+  // returns with queue of two entries
+  ClearScreen(RED);
+  // main program works in steps of 64 cycles till queue is sent
+  while (HostSpiBusy()) {
+    HostCpuRun(64);
+    work += 64;
+  }
+  cycles = hostCycles - cycles;
+  isr = hostIsrCycles - isr;
+  bytes = hostLcdBytes - bytes;
+  printf("async ClearScreen fosc/%d: %lu bytes in %lu cycles, interrupts %lu, main program %lu (%.0f %%);"
+    " polled at fosc/2 at least %lu cycles, main program 0\n", ST7735_SPI_DIV, (unsigned long) bytes,
+    (unsigned long) cycles, (unsigned long) isr, (unsigned long) work, 100.0 * work / cycles,
+    (unsigned long) bytes * 16);
+}
+#endif
+
+/**
+ * @desc    Main
+ *
+ * @param   int argc
+ * @param   char ** argv
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+  const char *write = NULL, *compare = NULL;
+  unsigned frames = 100, frame, scene;
+  char name[256];
+  uint32_t bytes, pixels;
+  unsigned delay, init = 0;
+  int32_t differ;
+#ifdef PERF_COUNTERS
+  TPerf counters;
+#endif
+  clock_t start;
+  double seconds;
+  int status = 0, i;
+
+  // arguments
+  for (i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-w") && (i + 1 < argc)) {
+      write = argv[++i];
+    } else if (!strcmp(argv[i], "-c") && (i + 1 < argc)) {
+      compare = argv[++i];
+    } else if (atoi(argv[i]) > 0) {
+      frames = (unsigned) atoi(argv[i]);
+    } else {
+      fprintf(stderr, "usage: uibench [-w dir | -c dir] [frames]\n");
+      return 2;
+    }
+  }
+  // controller init, delays summed not waited
+  while ((delay = DisplayInitStep()) != DISPLAY_INIT_DONE) {
+    init += delay;
+  }
+  // first screen of scanner - cached devices shown right after init
+  SetRotation(ROTATE_0);
+  ClearScreen(BLACK);
+  SceneScreen(0);
+  St7735Flush();
+  printf("first screen: init %u ms of delays, %lu bytes (%.1f ms at fosc/%d, 16 MHz)\n", init,
+    (unsigned long) hostLcdBytes, init + hostLcdBytes * 8.0 * ST7735_SPI_DIV / 16000.0, ST7735_SPI_DIV);
+
+  printf("%-8s %12s %14s  %s\n", "scene", "bytes/frame", "pixels/s", "result");
+  for (scene = 0; scene < sizeof(SCENES) / sizeof(SCENES[0]); scene++) {
+    // same start for every scene
+    SetRotation(ROTATE_0);
+    ClearScreen(BLACK);
+    if (SCENES[scene].prepare) {
+      SCENES[scene].prepare();
+    }
+    St7735Flush();
+    // frames
+    bytes = hostLcdBytes;
+    pixels = hostLcdPixels;
+    PerfReset();
+    start = clock();
+    for (frame = 0; frame < frames; frame++) {
+      SCENES[scene].draw(frame);
+    }
+    // queued output sent
+    St7735Flush();
+    seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    bytes = hostLcdBytes - bytes;
+    pixels = hostLcdPixels - pixels;
+    printf("%-8s %12.1f %14.0f  ", SCENES[scene].name, (double) bytes / frames,
+      (seconds > 0) ? pixels / seconds : 0.0);
+    // reference images
+    snprintf(name, sizeof(name), "%s/%s.ppm", write ? write : compare, SCENES[scene].golden);
+    // reference scenes only compared
+    if (write && strcmp(SCENES[scene].name, SCENES[scene].golden)) {
+      printf("-\n");
+    } else if (write) {
+      printf("%s\n", HostLcdDump(name) ? "cannot write" : name);
+    } else if (compare) {
+      differ = HostLcdCompare(name);
+      if (differ) {
+        status = 1;
+      }
+      if (differ < 0) {
+        printf("cannot read %s\n", name);
+      } else {
+        printf(differ ? "%d pixels differ\n" : "ok\n", differ);
+      }
+    } else {
+      printf("-\n");
+    }
+#ifdef PERF_COUNTERS
+    // driver counters per frame
+    PerfSnapshot(&counters);
+    printf("        ");
+    for (i = 0; i < PERF_SIZE; i++) {
+      if (PerfGet(&counters, i)) {
+        printf(" %s:%.1f", PerfName(i), (double) PerfGet(&counters, i) / frames);
+      }
+    }
+    printf("\n");
+#endif
+  }
+#ifdef ST7735_ASYNC
+  AsyncReport();
+#endif
+  // ROTATE_0 is mounting of init list, console rows follow memory rows
+  SetRotation(ROTATE_0);
+  St7735Flush();
+  if (hostLcdMadctl != ST7735_MADCTL) {
+    printf("MADCTL 0x%02X: ROTATE_0 writes 0x%02X\n", ST7735_MADCTL, hostLcdMadctl);
+    status = 1;
+  }
+  SetRotation(CONSOLE_ROTATION);
+  St7735Flush();
+  if (hostLcdMadctl & 0xA0) {
+    printf("MADCTL 0x%02X: console writes 0x%02X, MY or MV set\n", ST7735_MADCTL, hostLcdMadctl);
+    status = 1;
+  }
+  // rotations keep BGR and refresh order of ST7735_MADCTL
+  if (hostLcdBaseChanges) {
+    printf("MADCTL 0x%02X: ML, RGB, MH changed by %lu writes\n", ST7735_MADCTL, (unsigned long) hostLcdBaseChanges);
+    status = 1;
+  }
+  return status;
+}